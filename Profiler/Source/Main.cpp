@@ -0,0 +1,89 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 19 Oct 2026 2:40:41pm
+    Author:  Ben Hayes
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Source/OfflineRenderer.h"
+#include "../../Source/PluginProcessor.h"
+#include <iostream>
+
+//==============================================================================
+// Renders input_file through the plugin with its default settings, and
+// writes the per-stage timings the plugin recorded as JSON, to json_file or
+// to stdout if there isn't one. This lets us see which stages dominate
+// without a host or an editor.
+static int dumpPerformanceJSON(
+    const File& input_file,
+    const File& json_file,
+    int block_size)
+{
+    MultibandCompressorAudioProcessor processor;
+    OfflineRenderer::Options options;
+    options.block_size = block_size;
+    OfflineRenderer renderer (processor, options);
+
+    // We only want the timings, so the audio is thrown away
+    TemporaryFile output_file (".wav");
+    auto result = renderer.render(input_file, output_file.getFile());
+    if (result.failed())
+    {
+        std::cerr << result.getErrorMessage() << std::endl;
+        return 1;
+    }
+
+    auto& monitor = processor.getPerformanceMonitor();
+    if (json_file == File())
+    {
+        std::cout << monitor.toJSON() << std::endl;
+        return 0;
+    }
+    if (! monitor.dumpToFile(json_file))
+    {
+        std::cerr << "Couldn't write " << json_file.getFullPathName() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+//==============================================================================
+// The plugin built with MBC_ENABLE_INSTRUMENTATION=1, driven from the
+// command line. The unit tests are built without it, so they test what we
+// ship, and their benchmarks don't time the timers.
+//
+// Options:
+//   --dump-json=<file>     render an audio file through the plugin and print
+//                          its performance timings as JSON
+//   --json-file=<file>     write the JSON here instead of to stdout
+//   --block-size=<n>       render in blocks of n samples (default: 512)
+int main (int argc, char* argv[])
+{
+    ScopedJuceInitialiser_GUI juce_initialiser;
+    ArgumentList arguments (argc, argv);
+
+    if (! arguments.containsOption("--dump-json"))
+    {
+        std::cerr << "Usage: " << arguments.executableName
+                  << " --dump-json=<file> [--json-file=<file>] [--block-size=<n>]"
+                  << std::endl;
+        return 1;
+    }
+
+    auto json_file = File();
+    if (arguments.containsOption("--json-file"))
+        json_file = File::getCurrentWorkingDirectory().getChildFile(
+            arguments.getValueForOption("--json-file"));
+    auto block_size = 512;
+    if (arguments.containsOption("--block-size"))
+        block_size = jmax(1, arguments.getValueForOption("--block-size").getIntValue());
+    return dumpPerformanceJSON(
+        File::getCurrentWorkingDirectory().getChildFile(
+            arguments.getValueForOption("--dump-json")),
+        json_file,
+        block_size);
+}
@@ -0,0 +1,52 @@
+/*
+  ==============================================================================
+
+    AnalyserTap.cpp
+    Created: 19 Oct 2026 2:04:39pm
+    Author:  Ben Hayes
+
+  ==============================================================================
+*/
+
+#include "AnalyserTap.h"
+
+constexpr int AnalyserTap::fifo_size;
+
+void AnalyserTap::prepare(double sample_rate_in_hz)
+{
+    // The FIFO doesn't depend on the sample rate or block size, so we only
+    // ever allocate it once. The analyser may be pulling from it already.
+    if (samples_.empty())
+        samples_.resize((size_t) fifo_size);
+    sample_rate_in_hz_ = sample_rate_in_hz;
+    is_prepared_ = true;
+}
+
+int AnalyserTap::pull(float* destination, int max_samples) noexcept
+{
+    int start_1, size_1, start_2, size_2;
+    fifo_.prepareToRead(max_samples, start_1, size_1, start_2, size_2);
+    if (size_1 > 0)
+        FloatVectorOperations::copy(
+            destination,
+            samples_.data() + start_1,
+            size_1);
+    if (size_2 > 0)
+        FloatVectorOperations::copy(
+            destination + size_1,
+            samples_.data() + start_2,
+            size_2);
+    fifo_.finishedRead(size_1 + size_2);
+    return size_1 + size_2;
+}
+
+void AnalyserTap::setActive(bool should_be_active) noexcept
+{
+    // Throwing away whatever is waiting means the analyser starts from
+    // fresh audio, rather than whatever was left from the last time it
+    // listened. Only the reading side moves, so this is safe while the
+    // audio thread is writing.
+    if (should_be_active)
+        fifo_.finishedRead(fifo_.getNumReady());
+    is_active_ = should_be_active;
+}
@@ -0,0 +1,107 @@
+/*
+  ==============================================================================
+
+    AnalyserTap.h
+    Created: 19 Oct 2026 2:04:39pm
+    Author:  Ben Hayes
+    Description:
+
+    The audio thread's half of the editor's spectrum analyser. All the
+    audio thread does is mix each block down to mono and copy it into a
+    lock-free FIFO, which costs about as much as a memcpy of the block. The
+    windowing, FFTs and smoothing all happen on the message thread, in the
+    SpectrumAnalyser component, which pulls the samples back out.
+
+    The tap only runs while an analyser is listening, so a plugin with its
+    editor closed pays nothing but an atomic load. If the analyser falls
+    behind and the FIFO fills up, new samples are dropped until it catches
+    up: the audio thread never waits for it.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <vector>
+
+class AnalyserTap
+{
+public:
+    // Enough for a few hundred milliseconds at 96kHz, so the message thread
+    // can stall for a while without losing anything
+    static constexpr int fifo_size = 1 << 15;
+
+    // Allocates the FIFO the first time we're prepared. Never called on the
+    // audio thread.
+    void prepare(double sample_rate_in_hz);
+
+    // Called from the audio thread only
+    template <typename FloatType>
+    void push(const AudioBuffer<FloatType>& buffer) noexcept
+    {
+        if (! is_active_.load(std::memory_order_relaxed)
+            || ! is_prepared_.load())
+            return;
+
+        auto num_channels = jmin(2, buffer.getNumChannels());
+        if (num_channels == 0)
+            return;
+
+        int start_1, size_1, start_2, size_2;
+        fifo_.prepareToWrite(
+            buffer.getNumSamples(),
+            start_1,
+            size_1,
+            start_2,
+            size_2);
+        mixDown(buffer, num_channels, 0, start_1, size_1);
+        mixDown(buffer, num_channels, size_1, start_2, size_2);
+        fifo_.finishedWrite(size_1 + size_2);
+    }
+
+    // Called from the analyser's thread only. Copies up to max_samples of
+    // the oldest samples waiting into destination, and returns how many it
+    // copied.
+    int pull(float* destination, int max_samples) noexcept;
+
+    // Turns the tap on and off. Samples from before it was last turned on
+    // are thrown away.
+    void setActive(bool should_be_active) noexcept;
+    bool isActive() const noexcept { return is_active_.load(); }
+
+    double getSampleRate() const noexcept { return sample_rate_in_hz_.load(); }
+
+private:
+    template <typename FloatType>
+    void mixDown(
+        const AudioBuffer<FloatType>& buffer,
+        int num_channels,
+        int start_sample,
+        int fifo_start,
+        int num_samples) noexcept
+    {
+        if (num_samples <= 0)
+            return;
+
+        auto destination = samples_.data() + fifo_start;
+        auto left = buffer.getReadPointer(0, start_sample);
+        if (num_channels == 1)
+        {
+            for (auto i = 0; i < num_samples; i++)
+                destination[i] = (float) left[i];
+            return;
+        }
+
+        auto right = buffer.getReadPointer(1, start_sample);
+        for (auto i = 0; i < num_samples; i++)
+            destination[i] = (float) ((left[i] + right[i]) * (FloatType) 0.5);
+    }
+
+    AbstractFifo fifo_ {fifo_size};
+    std::vector<float> samples_;
+    std::atomic<bool> is_active_ {false};
+    std::atomic<bool> is_prepared_ {false};
+    std::atomic<double> sample_rate_in_hz_ {0.0};
+};
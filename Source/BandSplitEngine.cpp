@@ -0,0 +1,324 @@
+/*
+  ==============================================================================
+
+    BandSplitEngine.cpp
+    Created: 19 Oct 2026 2:02:40pm
+    Author:  Ben Hayes
+
+  ==============================================================================
+*/
+
+#include "BandSplitEngine.h"
+
+BandSplitEngine::BandSplitEngine(
+    const Array<CompressorProcessor*>& compressors,
+    const Array<CrossoverFilterProcessor*>& crossovers,
+    AudioParameterBool* control_rate_sidechain)
+    : compressors_ (compressors)
+{
+    // All the bands are compressed together by one compressor bank, which
+    // reads each band's settings from its CompressorProcessor:
+    compressor_bank_ = std::make_unique<CompressorBankProcessor>(
+        compressors_,
+        control_rate_sidechain);
+
+    // Our crossovers follow the plugin's crossover frequencies, but have
+    // filters of their own:
+    for (auto crossover : crossovers)
+    {
+        auto crossover_processor = std::make_unique<CrossoverFilterProcessor>(
+            crossover->cutoff_frequency_in_hz_);
+        // Complementary mode gives the same split for half the filtering
+        crossover_processor->setComplementaryMode(true);
+        crossovers_.add(crossover_processor.get());
+        crossover_processors_.push_back(std::move(crossover_processor));
+    }
+
+    // Each crossover only splits the high output of the one before it, so
+    // the lower bands would otherwise miss the phase shift of every later
+    // crossover and the bands wouldn't sum flat. We tell each crossover
+    // about all the ones that come after it so it can compensate:
+    for (auto i = 0; i < crossovers_.size(); i++)
+        for (auto j = i + 1; j < crossovers_.size(); j++)
+            crossovers_[i]->addPhaseCompensationFor(*crossovers_[j]);
+}
+
+void BandSplitEngine::prepare(
+    double sample_rate_in_hz,
+    int max_block_size,
+    bool use_double_precision)
+{
+    // None of our stages ever see the host's buffer size: we always feed
+    // them sub-blocks of a fixed size, which keeps all our band buffers
+    // small enough to stay in cache.
+    auto internal_block_size = sub_block_scheduler_.getSubBlockSize();
+
+    // Each crossover takes a stereo input and gives two stereo outputs, and
+    // the compressor bank takes a stereo pair of channels for every band
+    // and compresses them in place.
+    for (auto crossover : crossovers_)
+    {
+        crossover->setPlayConfigDetails(2, 4, sample_rate_in_hz, internal_block_size);
+        crossover->prepareToPlay(sample_rate_in_hz, internal_block_size);
+    }
+    compressor_bank_->setPlayConfigDetails(
+        2 * compressors_.size(),
+        2 * compressors_.size(),
+        sample_rate_in_hz,
+        internal_block_size);
+    compressor_bank_->prepareToPlay(sample_rate_in_hz, internal_block_size);
+
+    // Starting or stopping the split fades over one sub-block
+    split_fade_.reset(internal_block_size);
+
+    // We only need our band buffers and delay lines in the precision the
+    // host has asked for:
+    if (use_double_precision)
+        prepareBandProcessing(double_state_);
+    else
+        prepareBandProcessing(float_state_);
+
+    // Make sure we start from a clean slate
+    reset();
+}
+
+template <typename FloatType>
+void BandSplitEngine::prepareBandProcessing(
+    BandProcessingState<FloatType>& state)
+{
+    state.bands.prepare(
+        compressors_.size(),
+        2,
+        sub_block_scheduler_.getSubBlockSize());
+
+    // Each band goes through every crossover up to and including the one
+    // that splits it off (the last band shares its crossover with the one
+    // below), and then the compressor bank. We add up the latency of each
+    // band's path, and let our latency manager delay the quicker bands to
+    // match the slowest one. Whatever that comes to is our latency.
+    Array<int> band_latencies;
+    auto path_latency = 0;
+    for (auto band = 0; band < compressors_.size(); band++)
+    {
+        if (band < crossovers_.size())
+            path_latency += crossovers_[band]->getLatencySamples();
+        band_latencies.add(path_latency + compressor_bank_->getLatencySamples());
+    }
+    state.latency_manager.prepare(band_latencies, 2);
+    latency_in_samples_ = state.latency_manager.getLatencySamples();
+
+    state.dry.setSize(2, sub_block_scheduler_.getSubBlockSize());
+}
+
+void BandSplitEngine::reset()
+{
+    resetBandSplit();
+
+    // There's nothing to fade from after a reset
+    is_splitting_bands_ = needsBandSplit();
+    split_fade_.setCurrentAndTargetValue(is_splitting_bands_ ? 1.0f : 0.0f);
+}
+
+void BandSplitEngine::resetBandSplit()
+{
+    // Pass this on to every crossover and the compressor bank, and line
+    // our own sub-blocks back up with theirs:
+    for (auto crossover : crossovers_)
+        crossover->reset();
+    compressor_bank_->reset();
+    float_state_.latency_manager.reset();
+    double_state_.latency_manager.reset();
+    sub_block_scheduler_.reset();
+}
+
+#if MBC_ENABLE_INSTRUMENTATION
+void BandSplitEngine::setPerformanceStages(const PerformanceStages& stages)
+{
+    compressor_bank_->setPerformanceMonitor(stages.monitor, stages.compressors);
+    for (auto i = 0; i < crossovers_.size(); i++)
+        crossovers_[i]->setPerformanceMonitor(stages.monitor, stages.crossovers[i]);
+    performance_monitor_ = stages.monitor;
+    summing_stage_ = stages.summing;
+}
+#endif
+
+bool BandSplitEngine::needsBandSplit() const
+{
+    // When every band is a dynamic EQ, the split would only be summed
+    // straight back together again, so we can skip the crossovers and the
+    // compressor bank altogether. Muting or soloing still needs the bands
+    // separating, and so does any latency we've reported for them.
+    if (latency_in_samples_ > 0)
+        return true;
+
+    for (auto compressor : compressors_)
+        if (compressor->getBandType() == CompressorProcessor::BandType::compressor
+            || compressor->mute_->get()
+            || compressor->solo_->get())
+            return true;
+
+    return false;
+}
+
+void BandSplitEngine::process(AudioBuffer<float>& buffer)
+{
+    process(buffer, float_state_);
+}
+
+void BandSplitEngine::process(AudioBuffer<double>& buffer)
+{
+    process(buffer, double_state_);
+}
+
+template <typename FloatType>
+void BandSplitEngine::process(
+    AudioBuffer<FloatType>& buffer,
+    BandProcessingState<FloatType>& state)
+{
+    // Going from the split to the dry input (or back) would be a step from
+    // the crossovers' allpass phase response to none at all, so we fade
+    // between the two over a sub-block. Only once we've faded all the way
+    // out do the crossovers stop, and they start again from silence.
+    auto should_split_bands = needsBandSplit();
+    if (should_split_bands != is_splitting_bands_)
+    {
+        auto is_split_running = is_splitting_bands_ || split_fade_.isSmoothing();
+        if (should_split_bands && ! is_split_running)
+            resetBandSplit();
+        is_splitting_bands_ = should_split_bands;
+        split_fade_.setTargetValue(should_split_bands ? 1.0f : 0.0f);
+    }
+
+    if (! is_splitting_bands_ && ! split_fade_.isSmoothing())
+        return;
+    if (buffer.getNumChannels() == 0)
+        return;
+
+    // We cascade our buffer through all of our processors, one fixed size
+    // sub-block at a time. Our scheduler counts sub-blocks exactly the same
+    // way as the ones inside each crossover and the compressor bank, so
+    // none of the pieces we pass in straddle a control rate update.
+    sub_block_scheduler_.process(
+        buffer.getNumSamples(),
+        [this, &buffer, &state] (
+            int start_sample,
+            int num_samples,
+            bool)
+        {
+            processSubBlock(buffer, state, start_sample, num_samples);
+        });
+}
+
+template <typename FloatType>
+void BandSplitEngine::processSubBlock(
+    AudioBuffer<FloatType>& buffer,
+    BandProcessingState<FloatType>& state,
+    int start_sample,
+    int num_samples)
+{
+    // If we finished fading out partway through the host's buffer, the
+    // rest of it is left dry.
+    auto is_fading = split_fade_.isSmoothing();
+    if (! is_fading && ! is_splitting_bands_)
+        return;
+
+    auto& bands = state.bands;
+    if (is_fading)
+        for (auto channel = 0; channel < jmin(2, buffer.getNumChannels()); channel++)
+            state.dry.copyFrom(channel, 0, buffer, channel, start_sample, num_samples);
+
+    // Our input goes into the first band. With a mono input we copy the
+    // one channel into both, so that the compressor bank's detector, which
+    // takes the mean of each band's two channels, sees the signal at its
+    // true level. The duplicate is dropped again when we sum the bands.
+    auto num_input_channels = jmin(2, buffer.getNumChannels());
+    for (auto channel = 0; channel < 2; channel++)
+        FloatVectorOperations::copy(
+            bands.getWritePointer(0, channel),
+            buffer.getReadPointer(jmin(channel, num_input_channels - 1), start_sample),
+            num_samples);
+
+    // Each crossover splits the band it's given in place: the low side
+    // stays where it is and the high side goes on into the next band,
+    // ready for the next crossover.
+    for (auto i = 0; i < crossovers_.size(); i++)
+    {
+        auto split_bands = bands.getBands(i, 2, num_samples);
+        crossovers_[i]->processBlock(split_bands, midi_messages_);
+    }
+
+    // Then we compress every band at once
+    auto all_bands = bands.getBands(0, bands.getNumBands(), num_samples);
+    compressor_bank_->processBlock(all_bands, midi_messages_);
+
+    // Any band that got through quicker than the others is held back so
+    // they all line up again:
+    state.latency_manager.process(bands, num_samples);
+
+    sumBands(buffer, bands, start_sample, num_samples);
+
+    if (is_fading)
+        crossfadeWithDry(buffer, state.dry, start_sample, num_samples);
+}
+
+template <typename FloatType>
+void BandSplitEngine::crossfadeWithDry(
+    AudioBuffer<FloatType>& buffer,
+    const AudioBuffer<FloatType>& dry,
+    int start_sample,
+    int num_samples)
+{
+    // The dry input and the split are lined up, since we only ever stop
+    // splitting when we have no latency, so we can mix them sample for
+    // sample.
+    auto num_channels = jmin(2, buffer.getNumChannels());
+    for (auto n = 0; n < num_samples; n++)
+    {
+        auto split_gain = (FloatType) split_fade_.getNextValue();
+        for (auto channel = 0; channel < num_channels; channel++)
+        {
+            auto output = buffer.getWritePointer(channel, start_sample);
+            auto input = dry.getReadPointer(channel);
+            output[n] = input[n] + split_gain * (output[n] - input[n]);
+        }
+    }
+}
+
+template <typename FloatType>
+void BandSplitEngine::sumBands(
+    AudioBuffer<FloatType>& buffer,
+    const BandBufferStore<FloatType>& bands,
+    int start_sample,
+    int num_samples)
+{
+    MBC_TIME_STAGE(performance_monitor_, summing_stage_);
+
+    // And finally, we sum all our bands back into the host's buffer. Bands
+    // that have been muted are skipped entirely.
+    auto num_output_channels = jmin(2, buffer.getNumChannels());
+    for (auto channel = 0; channel < num_output_channels; channel++)
+    {
+        auto output = buffer.getWritePointer(channel, start_sample);
+        auto is_first_band = true;
+        for (auto band = 0; band < bands.getNumBands(); band++)
+        {
+            if (! compressor_bank_->isBandAudible(band))
+                continue;
+
+            if (is_first_band)
+                FloatVectorOperations::copy(
+                    output,
+                    bands.getWritePointer(band, channel),
+                    num_samples);
+            else
+                FloatVectorOperations::add(
+                    output,
+                    bands.getWritePointer(band, channel),
+                    num_samples);
+            is_first_band = false;
+        }
+
+        if (is_first_band)
+            FloatVectorOperations::clear(output, num_samples);
+    }
+}
@@ -0,0 +1,126 @@
+/*
+  ==============================================================================
+
+    BandSplitEngine.h
+    Created: 19 Oct 2026 2:02:40pm
+    Author:  Ben Hayes
+    Description:
+
+    The multiband process proper: a chain of Linkwitz-Riley crossovers
+    splits the input into bands, the compressor bank compresses them all
+    at once, and they're lined up and summed back together.
+
+    The engine has its own crossover filters and compressor bank, following
+    the plugin's parameters, so a fresh one can be built alongside whichever
+    engine is playing. Each band's audio lives in a BandBufferStore, and the
+    whole chain runs one fixed size sub-block at a time so that it all
+    stays in cache.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "MultibandEngine.h"
+#include "BandBufferStore.h"
+#include "CompressorBankProcessor.h"
+#include "CompressorProcessor.h"
+#include "CrossoverFilterProcessor.h"
+#include "LatencyManager.h"
+#include "SubBlockScheduler.h"
+#include <vector>
+
+class BandSplitEngine : public MultibandEngine
+{
+public:
+    BandSplitEngine(
+        const Array<CompressorProcessor*>& compressors,
+        const Array<CrossoverFilterProcessor*>& crossovers,
+        AudioParameterBool* control_rate_sidechain);
+
+    void prepare(
+        double sample_rate_in_hz,
+        int max_block_size,
+        bool use_double_precision) override;
+    void reset() override;
+    void process(AudioBuffer<float>& buffer) override;
+    void process(AudioBuffer<double>& buffer) override;
+    int getLatencySamples() const override { return latency_in_samples_; }
+
+   #if MBC_ENABLE_INSTRUMENTATION
+    void setPerformanceStages(const PerformanceStages& stages) override;
+   #endif
+
+private:
+    // Everything our sub-block processing needs in one precision. Only the
+    // state for the precision we're processing in is allocated.
+    template <typename FloatType>
+    struct BandProcessingState
+    {
+        // Every band's audio for one sub-block
+        BandBufferStore<FloatType> bands;
+        // Lines the bands up again before they're summed
+        LatencyManager<FloatType> latency_manager;
+        // A copy of one sub-block's input, to crossfade from or to when we
+        // start or stop splitting
+        AudioBuffer<FloatType> dry;
+    };
+
+    template <typename FloatType>
+    void prepareBandProcessing(BandProcessingState<FloatType>& state);
+    template <typename FloatType>
+    void process(
+        AudioBuffer<FloatType>& buffer,
+        BandProcessingState<FloatType>& state);
+    template <typename FloatType>
+    void processSubBlock(
+        AudioBuffer<FloatType>& buffer,
+        BandProcessingState<FloatType>& state,
+        int start_sample,
+        int num_samples);
+    template <typename FloatType>
+    void sumBands(
+        AudioBuffer<FloatType>& buffer,
+        const BandBufferStore<FloatType>& bands,
+        int start_sample,
+        int num_samples);
+    template <typename FloatType>
+    void crossfadeWithDry(
+        AudioBuffer<FloatType>& buffer,
+        const AudioBuffer<FloatType>& dry,
+        int start_sample,
+        int num_samples);
+    bool needsBandSplit() const;
+    void resetBandSplit();
+
+    Array<CompressorProcessor*> compressors_;
+    std::vector<std::unique_ptr<CrossoverFilterProcessor>> crossover_processors_;
+    Array<CrossoverFilterProcessor*> crossovers_;
+    std::unique_ptr<CompressorBankProcessor> compressor_bank_;
+
+    BandProcessingState<float> float_state_;
+    BandProcessingState<double> double_state_;
+    int latency_in_samples_ = 0;
+
+    // Chops the host's buffers up so every stage only ever sees fixed size
+    // sub-blocks
+    SubBlockScheduler sub_block_scheduler_;
+
+    // Whether we're splitting into bands, and how far we've faded from the
+    // dry input over to the split: 1 while splitting, 0 while not, ramping
+    // over one sub-block when that changes. The crossovers keep running
+    // until we've faded out, and start again from silence when we go back
+    // to them.
+    bool is_splitting_bands_ = true;
+    SmoothedValue<float> split_fade_;
+
+    // Always empty, but processBlock needs one
+    MidiBuffer midi_messages_;
+
+   #if MBC_ENABLE_INSTRUMENTATION
+    PerformanceMonitor* performance_monitor_ = nullptr;
+    int summing_stage_ = -1;
+   #endif
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BandSplitEngine)
+};
@@ -0,0 +1,414 @@
+/*
+  ==============================================================================
+
+    CompressorBankProcessor.cpp
+    Created: 19 Oct 2026 1:41:12pm
+    Author:  Ben Hayes
+
+  ==============================================================================
+*/
+
+#include "CompressorBankProcessor.h"
+
+constexpr int CompressorBankProcessor::max_control_interval;
+constexpr float CompressorBankProcessor::min_steps_per_attack;
+
+CompressorBankProcessor::CompressorBankProcessor(
+    const Array<CompressorProcessor*>& compressors,
+    AudioParameterBool* control_rate_sidechain)
+    : compressors_ (compressors),
+      control_rate_sidechain_ (control_rate_sidechain),
+      num_bands_ (compressors.size()),
+      band_states_ ((size_t) compressors.size())
+{
+    // Round the bands up to a whole number of registers. The spare lanes
+    // are never given any settings, so they just compute a gain of 0dB.
+    auto lanes_per_register = (int) Register::SIMDNumElements;
+    num_registers_ = (num_bands_ + lanes_per_register - 1) / lanes_per_register;
+    num_lanes_ = num_registers_ * lanes_per_register;
+    register_is_active_.assign((size_t) num_registers_, true);
+    register_intervals_.assign((size_t) num_registers_, 1);
+    register_positions_.assign((size_t) num_registers_, 0);
+    jassert(scheduler_.getSubBlockSize() % max_control_interval == 0);
+    band_gains_.assign((size_t) scheduler_.getSubBlockSize(), 1.0f);
+    double_band_gains_.assign((size_t) scheduler_.getSubBlockSize(), 1.0);
+
+    // Everything here is sized by the number of bands and the sub-block
+    // size, both of which are fixed, so we can allocate it all up front.
+    kernels_ = allocateRegisterAligned<Kernel>(
+        kernel_memory_,
+        (size_t) num_registers_);
+    for (auto i = 0; i < num_registers_; i++)
+        new (kernels_ + i) Kernel();
+
+    auto control_size = (size_t) (num_lanes_ * scheduler_.getSubBlockSize());
+    control_ = allocateRegisterAligned<float>(control_memory_, control_size);
+    std::fill(
+        control_,
+        control_ + control_size,
+        DecibelTables::minus_infinity_db);
+}
+
+CompressorBankProcessor::~CompressorBankProcessor()
+{
+    for (auto i = 0; i < num_registers_; i++)
+        kernels_[i].~Kernel();
+}
+
+void CompressorBankProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
+{
+    sample_rate_in_hz_ = (float) sampleRate;
+    for (auto& state : band_states_)
+    {
+        state.level.reset(sampleRate, switch_fade_in_seconds);
+        state.compression.reset(sampleRate, switch_fade_in_seconds);
+    }
+    reset();
+}
+
+void CompressorBankProcessor::processBlock(
+    AudioBuffer<float>& buffer,
+    MidiBuffer& midiMessages)
+{
+    process(buffer);
+}
+
+void CompressorBankProcessor::processBlock(
+    AudioBuffer<double>& buffer,
+    MidiBuffer& midiMessages)
+{
+    process(buffer);
+}
+
+void CompressorBankProcessor::reset()
+{
+    for (auto i = 0; i < num_registers_; i++)
+        kernels_[i].gain_smoother.reset();
+    std::fill(register_positions_.begin(), register_positions_.end(), 0);
+    for (auto band = 0; band < num_bands_; band++)
+    {
+        // The smoother starts at 0dB, leaving just the make-up gain
+        auto& state = band_states_[(size_t) band];
+        state.gain = decibel_tables_->decibelsToGain(
+            compressors_[band]->makeup_gain_in_db_->get());
+        state.target_gain = state.gain;
+    }
+    scheduler_.reset();
+
+    // There's nothing to fade from after a reset, so we go straight to
+    // whatever the switches say:
+    updateBandStates(true);
+}
+
+template <typename FloatType>
+void CompressorBankProcessor::process(AudioBuffer<FloatType>& buffer)
+{
+    MBC_TIME_STAGE(performance_monitor_, performance_stage_);
+
+    jassert(buffer.getNumChannels() >= 2 * num_bands_);
+
+    // Our control buffer holds one sub-block, and the scheduler makes sure
+    // we're never handed more than that at once:
+    scheduler_.process(
+        buffer.getNumSamples(),
+        [this, &buffer] (int start_sample, int num_samples, bool is_new_sub_block)
+        {
+            if (is_new_sub_block)
+                updateCoefficients();
+
+            detectLevels(buffer, start_sample, num_samples);
+            computeGains(num_samples);
+            applyGains(buffer, start_sample, num_samples);
+
+            for (auto i = 0; i < num_registers_; i++)
+                register_positions_[(size_t) i] =
+                    (register_positions_[(size_t) i] + num_samples)
+                    % register_intervals_[(size_t) i];
+        });
+}
+
+void CompressorBankProcessor::updateCoefficients()
+{
+    updateBandStates(false);
+
+    // Every interval divides the sub-block, so we're at the start of one in
+    // every register, and can change them freely. In control rate mode, a
+    // register steps as often as the fastest attack among its bands needs.
+    auto lanes_per_register = (int) Register::SIMDNumElements;
+    auto is_control_rate = control_rate_sidechain_->get();
+    for (auto i = 0; i < num_registers_; i++)
+    {
+        auto interval = is_control_rate ? max_control_interval : 1;
+        for (auto lane = 0; lane < lanes_per_register; lane++)
+        {
+            auto band = i * lanes_per_register + lane;
+            if (band >= num_bands_)
+                break;
+
+            // Our times are stored in milliseconds
+            auto attack_in_samples = compressors_[band]->attack_in_seconds_->get()
+                * 0.001f * sample_rate_in_hz_;
+            while (interval > 1
+                   && attack_in_samples < (float) interval * min_steps_per_attack)
+                interval /= 2;
+        }
+        jassert(register_positions_[(size_t) i] == 0);
+        register_intervals_[(size_t) i] = interval;
+    }
+
+    // Each band's settings go into its own lane:
+    for (auto band = 0; band < num_bands_; band++)
+    {
+        auto compressor = compressors_[band];
+        auto& kernel = kernels_[band / lanes_per_register];
+        auto lane = (size_t) (band % lanes_per_register);
+
+        kernel.gain_computer.setParameters(
+            lane,
+            compressor->threshold_in_db_->get(),
+            compressor->ratio_->get(),
+            compressor->knee_in_db_->get());
+        kernel.gain_computer.setLowerParameters(
+            lane,
+            (GainComputer<Register>::LowerMode) compressor->lower_mode_->getIndex(),
+            compressor->lower_threshold_in_db_->get(),
+            compressor->lower_ratio_->get(),
+            compressor->lower_range_in_db_->get());
+        // Our times are stored in milliseconds
+        kernel.gain_smoother.setTimes(
+            lane,
+            sample_rate_in_hz_,
+            compressor->attack_in_seconds_->get() * 0.001f,
+            compressor->release_in_seconds_->get() * 0.001f,
+            compressor->auto_release_->get(),
+            register_intervals_[(size_t) (band / lanes_per_register)]);
+    }
+}
+
+void CompressorBankProcessor::updateBandStates(bool should_jump_to_target)
+{
+    // A band is heard unless it's muted, or some other band is soloed and
+    // it isn't. It's compressed if it's heard, not bypassed, and not a
+    // dynamic EQ (those are shaped before they're split, so here they just
+    // pass through).
+    auto is_any_band_soloed = false;
+    for (auto compressor : compressors_)
+        is_any_band_soloed = is_any_band_soloed || compressor->solo_->get();
+
+    auto lanes_per_register = (int) Register::SIMDNumElements;
+    std::fill(register_is_active_.begin(), register_is_active_.end(), false);
+
+    for (auto band = 0; band < num_bands_; band++)
+    {
+        auto compressor = compressors_[band];
+        auto& state = band_states_[(size_t) band];
+
+        auto should_be_audible = ! compressor->mute_->get()
+            && (! is_any_band_soloed || compressor->solo_->get());
+        auto should_compress = should_be_audible
+            && ! compressor->bypass_->get()
+            && compressor->getBandType() == CompressorProcessor::BandType::compressor;
+
+        if (should_jump_to_target)
+        {
+            state.level.setCurrentAndTargetValue(should_be_audible ? 1.0f : 0.0f);
+            state.compression.setCurrentAndTargetValue(should_compress ? 1.0f : 0.0f);
+        } else
+        {
+            state.level.setTargetValue(should_be_audible ? 1.0f : 0.0f);
+            state.compression.setTargetValue(should_compress ? 1.0f : 0.0f);
+        }
+
+        // We keep the detector running for as long as any of the
+        // compressor's gain can still be heard. When it starts up again,
+        // its envelope starts again from scratch rather than from wherever
+        // it was when we stopped.
+        auto was_compressing = state.is_compressing;
+        state.is_compressing = state.compression.isSmoothing()
+            || state.compression.getTargetValue() > 0.0f;
+        state.is_audible = state.level.isSmoothing()
+            || state.level.getTargetValue() > 0.0f;
+
+        if (state.is_compressing && ! was_compressing)
+        {
+            kernels_[band / lanes_per_register].gain_smoother.resetLane(
+                (size_t) (band % lanes_per_register));
+            state.gain = decibel_tables_->decibelsToGain(
+                compressor->makeup_gain_in_db_->get());
+            state.target_gain = state.gain;
+        }
+        if (state.is_compressing)
+            register_is_active_[(size_t) (band / lanes_per_register)] = true;
+    }
+}
+
+template <typename FloatType>
+void CompressorBankProcessor::detectLevels(
+    const AudioBuffer<FloatType>& buffer,
+    int start_sample,
+    int num_samples)
+{
+    // Peak detection on the mean of each band's two channels, converted to
+    // dB with our lookup table:
+    for (auto band = 0; band < num_bands_; band++)
+    {
+        if (! band_states_[(size_t) band].is_compressing)
+            continue;
+
+        auto left = buffer.getReadPointer(2 * band, start_sample);
+        auto right = buffer.getReadPointer(2 * band + 1, start_sample);
+        auto level_in_db = control_ + band;
+
+        for (auto n = 0; n < num_samples; n++, level_in_db += num_lanes_)
+            *level_in_db = decibel_tables_->gainToDecibels(
+                std::abs(0.5f * (float) (left[n] + right[n])));
+    }
+}
+
+void CompressorBankProcessor::computeGains(int num_samples)
+{
+    // This is the only loop with a dependency from one sample to the next,
+    // and each trip round it moves every band in a register on by one
+    // sample:
+    auto lanes_per_register = (int) Register::SIMDNumElements;
+    for (auto i = 0; i < num_registers_; i++)
+    {
+        if (! register_is_active_[(size_t) i])
+            continue;
+
+        auto& kernel = kernels_[i];
+        auto lanes = control_ + i * lanes_per_register;
+        auto interval = register_intervals_[(size_t) i];
+
+        if (interval == 1)
+        {
+            for (auto n = 0; n < num_samples; n++, lanes += num_lanes_)
+            {
+                auto gain_in_db = kernel.gain_computer.process(
+                    Register::fromRawArray(lanes));
+                kernel.gain_smoother.process(gain_in_db).copyToRawArray(lanes);
+            }
+            continue;
+        }
+
+        // At control rate, the envelopes only move at the end of each
+        // interval, and we leave their gain on that interval's last sample
+        // for the apply pass to ramp towards. The other samples' levels
+        // are left as they are, and never read again.
+        auto position = register_positions_[(size_t) i];
+        for (auto n = 0; n < num_samples; n++, lanes += num_lanes_)
+        {
+            kernel.gain_smoother.accumulate(
+                kernel.gain_computer.process(Register::fromRawArray(lanes)));
+            if (++position == interval)
+            {
+                position = 0;
+                kernel.gain_smoother.advance().copyToRawArray(lanes);
+            }
+        }
+    }
+}
+
+void CompressorBankProcessor::fillBandGains(int band, int num_samples)
+{
+    auto& state = band_states_[(size_t) band];
+    auto makeup_gain_in_db = compressors_[band]->makeup_gain_in_db_->get();
+    auto gain_in_db = control_ + band;
+    auto lanes_per_register = (int) Register::SIMDNumElements;
+    auto register_index = (size_t) (band / lanes_per_register);
+    auto interval = register_intervals_[register_index];
+
+    if (interval == 1)
+    {
+        for (auto n = 0; n < num_samples; n++, gain_in_db += num_lanes_)
+            band_gains_[(size_t) n] = decibel_tables_->decibelsToGain(
+                makeup_gain_in_db + *gain_in_db);
+        state.gain = band_gains_[(size_t) (num_samples - 1)];
+        state.target_gain = state.gain;
+        return;
+    }
+
+    // At control rate we ramp linearly towards the last control point's
+    // gain, reaching it at the end of the interval. Each run of the ramp
+    // has no dependency from one sample to the next.
+    auto position = register_positions_[register_index];
+    auto n = 0;
+    while (n < num_samples)
+    {
+        auto run = jmin(interval - position, num_samples - n);
+        auto increment = (state.target_gain - state.gain)
+            / (float) (interval - position);
+        auto gains = band_gains_.data() + n;
+        for (auto i = 0; i < run; i++)
+            gains[i] = state.gain + (float) (i + 1) * increment;
+
+        state.gain += (float) run * increment;
+        position += run;
+        n += run;
+
+        if (position == interval)
+        {
+            position = 0;
+            state.gain = state.target_gain;
+            state.target_gain = decibel_tables_->decibelsToGain(
+                makeup_gain_in_db + gain_in_db[(n - 1) * num_lanes_]);
+        }
+    }
+}
+
+template <typename FloatType>
+void CompressorBankProcessor::applyGains(
+    AudioBuffer<FloatType>& buffer,
+    int start_sample,
+    int num_samples)
+{
+    for (auto band = 0; band < num_bands_; band++)
+    {
+        auto& state = band_states_[(size_t) band];
+        auto is_fading = state.level.isSmoothing()
+            || state.compression.isSmoothing();
+
+        // Bands that can't be heard are left alone, and bands that are
+        // fully bypassed pass straight through:
+        if (! state.is_audible || (! state.is_compressing && ! is_fading))
+        {
+            state.level.skip(num_samples);
+            state.compression.skip(num_samples);
+            continue;
+        }
+
+        // We work out the band's gain for every sample first...
+        auto gains = band_gains_.data();
+        if (state.is_compressing)
+            fillBandGains(band, num_samples);
+        else
+            FloatVectorOperations::fill(gains, 1.0f, num_samples);
+
+        // ...fold in any fade, where the compressor's gain is faded towards
+        // unity, and the result faded towards silence...
+        if (is_fading)
+            for (auto n = 0; n < num_samples; n++)
+                gains[n] = state.level.getNextValue()
+                    * (1.0f + state.compression.getNextValue()
+                              * (gains[n] - 1.0f));
+
+        // ...and then apply it to each channel in one vectorised multiply,
+        // while the band is still in cache from the detector.
+        auto left = buffer.getWritePointer(2 * band, start_sample);
+        auto right = buffer.getWritePointer(2 * band + 1, start_sample);
+        auto channel_gains = getBandGains(left, num_samples);
+        FloatVectorOperations::multiply(left, channel_gains, num_samples);
+        FloatVectorOperations::multiply(right, channel_gains, num_samples);
+    }
+}
+
+const double* CompressorBankProcessor::getBandGains(
+    const double*,
+    int num_samples) noexcept
+{
+    // Our gains are worked out in float, so a double precision buffer needs
+    // them converting once per band, rather than once per channel.
+    for (auto n = 0; n < num_samples; n++)
+        double_band_gains_[(size_t) n] = (double) band_gains_[(size_t) n];
+    return double_band_gains_.data();
+}
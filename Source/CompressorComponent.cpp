@@ -7,8 +7,8 @@ LabelledSlider::LabelledSlider(
     Slider::TextEntryBoxPosition textPos)
 {
     // Set up the slider with the passed in parameters
-    setText(name);
-    setTextLabelPosition(Justification::centredTop);
+    setName(name);
+    setPaintingIsUnclipped(true);
 
     slider.setSliderStyle(style);
     slider.setTextBoxStyle(
@@ -33,11 +33,15 @@ void LabelledSlider::resized()
 
 void LabelledSlider::paint(Graphics& g)
 {
-    // make border transparent
-    setColour(
-        outlineColourId,
-        Colour());
-    GroupComponent::paint(g);
+    // All we draw ourselves is our name, centred along the top, in the same
+    // font and colour a GroupComponent would use
+    g.setColour(findColour(GroupComponent::textColourId));
+    g.setFont(Font(15.0f));
+    g.drawText(
+        getName(),
+        getLocalBounds().removeFromTop(15),
+        Justification::centredTop,
+        true);
 }
 
 CompressorComponent::CompressorComponent(
@@ -46,32 +50,16 @@ CompressorComponent::CompressorComponent(
     : p (p)
 {
     // Fairly self explanatory: simply set up all the UI components necessary
-    // to control a compressor
+    // to control a compressor. Their ranges and values come from the
+    // parameters once we're attached to the processor.
     setText(name);
     setTextLabelPosition(Justification::topLeft);
 
-    attack.slider.setRange(1.0, 150.0, 1.0);
-    attack.slider.setValue(10.0);
     attack.slider.setTextValueSuffix(" ms");
-
-    release.slider.setRange(1.0, 1000.0, 1.0);
-    release.slider.setValue(100.0);
     release.slider.setTextValueSuffix(" ms");
-
-    ratio.slider.setRange(1.0, 20.0, 0.1);
-    ratio.slider.setValue(2.0);
     ratio.slider.setTextValueSuffix("");
-
-    knee.slider.setRange(0.0, 32.0, 1.0);
-    knee.slider.setValue(0.0);
     knee.slider.setTextValueSuffix(" dB");
-
-    makeupGain.slider.setRange(0.0, 32.0, 0.1);
-    makeupGain.slider.setValue(0.0);
     makeupGain.slider.setTextValueSuffix(" dB");
-
-    threshold.slider.setRange(-66.6, 0.0, 0.1);
-    threshold.slider.setValue(-6.0);
     threshold.slider.setTextValueSuffix(" dB");
 
     addAndMakeVisible(&attack);
@@ -80,43 +68,89 @@ CompressorComponent::CompressorComponent(
     addAndMakeVisible(&knee);
     addAndMakeVisible(&makeupGain);
     addAndMakeVisible(&threshold);
+    addAndMakeVisible(&autoRelease);
+
+    addAndMakeVisible(&mute);
+    addAndMakeVisible(&solo);
+    addAndMakeVisible(&bypass);
+    addAndMakeVisible(&dynamicEq);
+}
+
+void CompressorComponent::paint(Graphics& g)
+{
+    // GroupComponent builds and strokes its outline's path every time it
+    // paints, and we're repainted behind every control that changes, so we
+    // draw it once into an image and just copy that.
+    if (cachedOutline.isNull())
+    {
+        cachedOutline = Image(
+            Image::ARGB,
+            jmax(1, getWidth()),
+            jmax(1, getHeight()),
+            true);
+        Graphics outlineGraphics (cachedOutline);
+        GroupComponent::paint(outlineGraphics);
+    }
+    g.drawImageAt(cachedOutline, 0, 0);
+}
+
+// Anything that changes how the outline is drawn throws away the cached one
+void CompressorComponent::lookAndFeelChanged()
+{
+    cachedOutline = Image();
+    GroupComponent::lookAndFeelChanged();
+}
+
+void CompressorComponent::colourChanged()
+{
+    cachedOutline = Image();
+    GroupComponent::colourChanged();
+}
+
+void CompressorComponent::enablementChanged()
+{
+    cachedOutline = Image();
+    GroupComponent::enablementChanged();
 }
 
 void CompressorComponent::resized()
 {
+    cachedOutline = Image();
     attack.setBounds(0, 20, 90, 40);
     release.setBounds(0, 57, 90, 40);
     ratio.setBounds(0, 94, 90, 40);
     knee.setBounds(0, 131, 90, 40);
     threshold.setBounds(70, 20, 80, 151);
     makeupGain.setBounds(130, 20, 80, 151);
+    mute.setBounds(50, 0, 26, 20);
+    solo.setBounds(76, 0, 26, 20);
+    bypass.setBounds(102, 0, 26, 20);
+    dynamicEq.setBounds(128, 0, 36, 20);
+    autoRelease.setBounds(164, 0, 46, 20);
 }
 
-void CompressorComponent::attachToProcessor()
+void CompressorComponent::attachToProcessor(ParameterBindings& bindings)
 {
     // CompressorComponent is constructed with a pointer to its associated
-    // CompressorProcessor, so in this function we use lambda callbacks to
-    // attach the UI controls to the parameters in the relevant processor
-    attack.slider.onValueChange = [this] {
-        *(p->attack_in_seconds_) =
-            attack.slider.getValue();
-    };
-    release.slider.onValueChange = [this] {
-        *(p->release_in_seconds_) =
-            release.slider.getValue();
-    };
-    ratio.slider.onValueChange = [this] {
-        *(p->ratio_) = ratio.slider.getValue();
-    };
-    knee.slider.onValueChange = [this] {
-        *(p->knee_in_db_) = knee.slider.getValue();
-    };
-    makeupGain.slider.onValueChange = [this] {
-        *(p->makeup_gain_in_db_) =
-            makeupGain.slider.getValue();
-    };
-    threshold.slider.onValueChange = [this] {
-        *(p->threshold_in_db_) =
-            threshold.slider.getValue();
-    };
+    // CompressorProcessor, so in this function we bind each UI control to
+    // its parameter in the relevant processor. The bindings keep the two in
+    // step both ways, so the controls follow the host's automation too.
+    // The sliders step by whatever is sensible to show.
+    bindings.bind(attack.slider, *p->attack_in_seconds_, 1.0);
+    bindings.bind(release.slider, *p->release_in_seconds_, 1.0);
+    bindings.bind(ratio.slider, *p->ratio_, 0.1);
+    bindings.bind(knee.slider, *p->knee_in_db_, 0.1);
+    bindings.bind(makeupGain.slider, *p->makeup_gain_in_db_, 0.1);
+    bindings.bind(threshold.slider, *p->threshold_in_db_, 0.1);
+    bindings.bind(autoRelease, *p->auto_release_);
+    bindings.bind(mute, *p->mute_);
+    bindings.bind(solo, *p->solo_);
+    bindings.bind(bypass, *p->bypass_);
+    // The EQ switch turns the band into a dynamic EQ instead of a
+    // compressor:
+    bindings.bind(
+        dynamicEq,
+        *p->band_type_,
+        (int) CompressorProcessor::BandType::dynamic_eq,
+        (int) CompressorProcessor::BandType::compressor);
 }
\ No newline at end of file
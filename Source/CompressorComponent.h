@@ -2,10 +2,13 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "ParameterBindings.h"
 
-class LabelledSlider : public GroupComponent
+class LabelledSlider : public Component
 {
-// A GroupComponent derivative that creates a slider with an attached label
+// A slider with its name drawn above it. It used to be a GroupComponent
+// with an invisible outline, but that still built and stroked the outline
+// on every paint.
 public:
     LabelledSlider(
         const String& name,
@@ -24,8 +27,12 @@ class CompressorComponent : public GroupComponent
 // compressor processor.
 public:
     CompressorComponent(const String& name, CompressorProcessor* p);
+    void paint(Graphics& g) override;
     void resized() override;
-    void attachToProcessor();
+    void lookAndFeelChanged() override;
+    void colourChanged() override;
+    void enablementChanged() override;
+    void attachToProcessor(ParameterBindings& bindings);
 
     LabelledSlider attack {
         "Attack",
@@ -51,6 +58,14 @@ public:
         "Threshold",
         Slider::LinearVertical,
         Slider::TextBoxBelow};
+    ToggleButton autoRelease {"Auto"};
+    ToggleButton mute {"M"};
+    ToggleButton solo {"S"};
+    ToggleButton bypass {"B"};
+    ToggleButton dynamicEq {"EQ"};
 private:
     CompressorProcessor* p;
+    // Our outline and title, which only change with our size or look and
+    // feel, so we only draw them again then
+    Image cachedOutline;
 };
\ No newline at end of file
@@ -6,25 +6,29 @@
       Author:  Ben Hayes
       Description:
 
-      A dynamic range compressor implemented as a derivative of the
-      AudioProcessor base class.
+      Holds one band's compressor settings as plugin parameters. The
+      multiband engines read these to do the compressing itself, so this
+      class has no audio path of its own.
 
     ==============================================================================
 */
 
 #pragma once
 
-#include "ProcessorBase.h"
+#include <JuceHeader.h>
 
-class CompressorProcessor : public ProcessorBase
+class CompressorProcessor
 {
 public:
+    // What a band does in the multiband process. The choices of our
+    // band_type_ parameter line up with these.
+    enum class BandType
+    {
+        compressor = 0,
+        dynamic_eq
+    };
+
     CompressorProcessor(int index);
-    void prepareToPlay(double sampleRate, int samplesPerBlock) override;
-    void processBlock (
-        AudioSampleBuffer& buffer,
-        MidiBuffer& midiMessages) override;
-    const String getName() const override { return "Compressor"; }
     std::unique_ptr<AudioProcessorParameterGroup> getParameterTree();
 
     AudioParameterFloat* attack_in_seconds_;
@@ -33,21 +37,29 @@ public:
     AudioParameterFloat* knee_in_db_;
     AudioParameterFloat* threshold_in_db_;
     AudioParameterFloat* ratio_;
+    AudioParameterBool* auto_release_;
+
+    // The curve below a second, lower threshold: upward compression or
+    // downward expansion, limited to a range.
+    AudioParameterChoice* lower_mode_;
+    AudioParameterFloat* lower_threshold_in_db_;
+    AudioParameterFloat* lower_ratio_;
+    AudioParameterFloat* lower_range_in_db_;
+
+    // Whether the band is split off and compressed, or shaped in place by a
+    // dynamic bell or shelf filter
+    AudioParameterChoice* band_type_;
+    BandType getBandType() const noexcept
+    {
+        return (BandType) band_type_->getIndex();
+    }
+
+    // How this band is routed in the multiband process. Only the
+    // multiband engines act on these.
+    AudioParameterBool* mute_;
+    AudioParameterBool* solo_;
+    AudioParameterBool* bypass_;
 
 private:
-    float sample_rate_in_hz_;
-    float last_gain_in_db_ = 0.0f;
-    float alpha_a_;
-    float alpha_r_;
-
-    void calculateTimingCoefficients();
-    float detectLevelOverThreshold(
-        AudioSampleBuffer& buffer,
-        int sample_index);
-    float computeGain(float sample_over_threshold);
-    float applyTimeSmoothing(float gain_in_db);
-    void applyGain(
-        float gain_in_db,
-        AudioSampleBuffer& buffer,
-        int sample_index);
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CompressorProcessor)
 };
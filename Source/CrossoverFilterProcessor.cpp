@@ -10,15 +10,9 @@
 
 #include "CrossoverFilterProcessor.h"
 
-CrossoverFilterProcessor::CrossoverFilterProcessor(int index)
-    : low_pass_filter_0(
-          dsp::IIR::Coefficients<float>::makeLowPass(44100, 20000.0f)),
-      low_pass_filter_1(
-          dsp::IIR::Coefficients<float>::makeLowPass(44100, 20000.0f)),
-      high_pass_filter_0(
-          dsp::IIR::Coefficients<float>::makeHighPass(44100, 20000.0f)),
-      high_pass_filter_1(
-          dsp::IIR::Coefficients<float>::makeHighPass(44100, 20000.0f))
+CrossoverFilterProcessor::CrossoverFilterProcessor(
+    int index,
+    float default_cutoff_in_hz)
 {
     // We only need to expose one parameter: the crossover frequency.
     auto index_str = std::to_string(index + 1);
@@ -26,9 +20,16 @@ CrossoverFilterProcessor::CrossoverFilterProcessor(int index)
         new AudioParameterFloat(
             "cutoff_" + index_str,
             "Crossover " + index_str + " Frequency",
-            40.0,
-            20000.0,
-            1000.0);
+            40.0f,
+            20000.0f,
+            default_cutoff_in_hz);
+}
+
+CrossoverFilterProcessor::CrossoverFilterProcessor(
+    AudioParameterFloat* cutoff_frequency_in_hz)
+    : cutoff_frequency_in_hz_ (cutoff_frequency_in_hz),
+      owns_parameters_ (false)
+{
 }
 
 CrossoverFilterProcessor::~CrossoverFilterProcessor()
@@ -42,61 +43,74 @@ void CrossoverFilterProcessor::prepareToPlay(
     // Store a local copy of the sample rate
     sample_rate_in_hz_ = sampleRate;
 
-    // juce::dsp objects require a little extra setup. In particular, they
-    // require an instance of the dsp::ProcessSpec struct on preparation to
-    // play.
-    dsp::ProcessSpec spec;
-    spec.sampleRate = sampleRate;
-    spec.maximumBlockSize = samplesPerBlock;
-    spec.numChannels = 2;
-
-    low_pass_filter_0.prepare(spec);
-    low_pass_filter_1.prepare(spec);
-    high_pass_filter_0.prepare(spec);
-    high_pass_filter_1.prepare(spec);
+    // We don't know which precision the host will ask for until it starts
+    // calling processBlock, so both crossovers are made ready for our two
+    // channels, with an allpass section for each later crossover:
+    auto num_compensation_stages = phase_compensation_cutoffs_.size();
+    float_crossover_.setNumPhaseCompensationStages(num_compensation_stages);
+    double_crossover_.setNumPhaseCompensationStages(num_compensation_stages);
+    float_crossover_.prepare(2);
+    double_crossover_.prepare(2);
+}
+
+void CrossoverFilterProcessor::processBlock(
+    AudioBuffer<float>& buffer,
+    MidiBuffer& midiMessages)
+{
+    process(buffer, float_crossover_);
 }
 
 void CrossoverFilterProcessor::processBlock(
-    AudioSampleBuffer& buffer,
+    AudioBuffer<double>& buffer,
     MidiBuffer& midiMessages)
 {
-    // Make a two channel buffer that points to the first two channels in
-    // the buffer passed into the function
-    AudioSampleBuffer low_buffer{
-        buffer.getArrayOfWritePointers(),
-        2,
-        buffer.getNumSamples()};
-    
-    // Make another two channel buffer containing a copy of the first two
-    // channels, so that we can process it independently:
-    AudioSampleBuffer high_buffer{2, buffer.getNumSamples()};
-    high_buffer.makeCopyOf(low_buffer);
-
-    updateCoefficients();
-
-    // juce::dsp processors require input to be an AudioBlock<T> instance,
-    // so we need to construct these from our processing buffers
-    dsp::AudioBlock<float> low_block (low_buffer);
-    dsp::AudioBlock<float> high_block (high_buffer);
-
-    // Process one pair of channels with a cascade of second order low pass
-    // filters. These filters were constructed inside of an instance of
-    // dsp::ProcessorDuplicator which takes care of processing multiple 
-    // channels independently.
-    low_pass_filter_0.process(dsp::ProcessContextReplacing<float> (low_block));
-    low_pass_filter_1.process(dsp::ProcessContextReplacing<float> (low_block));
-
-    // Process the other pair of channels with a cascade of second order high
-    // pass filters:
-    high_pass_filter_0.process(dsp::ProcessContextReplacing<float> (high_block));
-    high_pass_filter_1.process(dsp::ProcessContextReplacing<float> (high_block));
-
-    // low_buffer already pointed to the raw sample data, so we don't need to 
-    // copy that, but high_buffer needs copying into the 3rd and 4th channel
-    // of the output buffer:
-    buffer.copyFrom(2, 0, high_block.getChannelPointer(0), buffer.getNumSamples());
-    buffer.copyFrom(3, 0, high_block.getChannelPointer(1), buffer.getNumSamples());
+    process(buffer, double_crossover_);
+}
 
+template <typename FloatType>
+void CrossoverFilterProcessor::process(
+    AudioBuffer<FloatType>& buffer,
+    LinkwitzRileyCrossover<FloatType>& crossover)
+{
+    MBC_TIME_STAGE(performance_monitor_, performance_stage_);
+
+    // We work through the buffer in fixed size sub-blocks, and only
+    // recalculate our coefficients at the start of each one, so the cost of
+    // doing so doesn't depend on how big the host's buffers are:
+    scheduler_.process(
+        buffer.getNumSamples(),
+        [this, &buffer, &crossover] (
+            int start_sample,
+            int num_samples,
+            bool is_new_sub_block)
+        {
+            if (is_new_sub_block)
+                updateCoefficients(crossover);
+            processSubBlock(buffer, crossover, start_sample, num_samples);
+        });
+}
+
+template <typename FloatType>
+void CrossoverFilterProcessor::processSubBlock(
+    AudioBuffer<FloatType>& buffer,
+    LinkwitzRileyCrossover<FloatType>& crossover,
+    int start_sample,
+    int num_samples)
+{
+    // The first two channels hold our input and will become our low pass
+    // output, and the 3rd and 4th channels will become our high pass
+    // output. The crossover kernel reads each input sample once and writes
+    // both outputs straight into place, so there's no copying between
+    // channels and only one pass over the block.
+    for (auto channel = 0; channel < 2; channel++)
+    {
+        crossover.process(
+            channel,
+            buffer.getReadPointer(channel, start_sample),
+            buffer.getWritePointer(channel, start_sample),
+            buffer.getWritePointer(channel + 2, start_sample),
+            num_samples);
+    }
 }
 
 std::unique_ptr<AudioProcessorParameterGroup> 
@@ -105,38 +119,70 @@ std::unique_ptr<AudioProcessorParameterGroup>
     // Return a unique pointer to a tree containing a reference to our
     // parameter and let the PluginProcessor take care of it. Makes our class
     // less portable but prevents memory leaks.
+    jassert(owns_parameters_);
     auto parameter_tree = std::make_unique<AudioProcessorParameterGroup>();
     parameter_tree->addChild(
         std::unique_ptr<AudioParameterFloat>(cutoff_frequency_in_hz_));
     return std::move(parameter_tree);
 }
 
+void CrossoverFilterProcessor::setComplementaryMode(
+    bool should_be_complementary)
+{
+    complementary_mode_ = should_be_complementary;
+}
+
+void CrossoverFilterProcessor::addPhaseCompensationFor(
+    const CrossoverFilterProcessor& later_crossover)
+{
+    phase_compensation_cutoffs_.add(later_crossover.cutoff_frequency_in_hz_);
+}
+
+double CrossoverFilterProcessor::getTailLengthSeconds() const
+{
+    // Our slowest poles belong to the lowest cutoff we filter at, whether
+    // that's our own or one of our phase compensation sections'. Every
+    // section is a Butterworth, whose poles decay with a time constant of
+    // sqrt(2) / (2.pi.fc). We allow long enough for two of them in series
+    // (the LR4's repeated poles) to each decay by 120dB.
+    auto lowest_cutoff_in_hz = (double) cutoff_frequency_in_hz_->get();
+    for (auto cutoff : phase_compensation_cutoffs_)
+        lowest_cutoff_in_hz = jmin(lowest_cutoff_in_hz, (double) cutoff->get());
+
+    auto time_constant_in_seconds = MathConstants<double>::sqrt2
+        / (MathConstants<double>::twoPi * lowest_cutoff_in_hz);
+    return 2.0 * std::log(1.0e6) * time_constant_in_seconds;
+}
+
 void CrossoverFilterProcessor::reset()
 {
     // Pass the reset call onto our filters
-    low_pass_filter_0.reset();
-    low_pass_filter_1.reset();
-    high_pass_filter_0.reset();
-    high_pass_filter_1.reset();
+    float_crossover_.reset();
+    double_crossover_.reset();
+
+    // And start counting sub-blocks from scratch
+    scheduler_.reset();
 }
 
-void CrossoverFilterProcessor::updateCoefficients()
+template <typename FloatType>
+void CrossoverFilterProcessor::updateCoefficients(
+    LinkwitzRileyCrossover<FloatType>& crossover)
 {
-    // Calculate coefficients using makeLowPass and makeHighPass static methods
-    // from dsp::IIR::Coefficients class.
-    // Not passing in a Q factor defaults to a Q factor of 1/sqrt(2), and
-    // therefore returns a second order Butterworth filter. This function
-    // also takes care of the frequency pre-warping
-    auto lpf_coeffs = *dsp::IIR::Coefficients<float>::makeLowPass(
-        sample_rate_in_hz_,
-        cutoff_frequency_in_hz_->get());
-    auto hpf_coeffs = *dsp::IIR::Coefficients<float>::makeHighPass(
-        sample_rate_in_hz_,
-        cutoff_frequency_in_hz_->get());
-    
-    // Update the filters to use the calculated coefficients:
-    *low_pass_filter_0.state = lpf_coeffs;
-    *low_pass_filter_1.state = lpf_coeffs;
-    *high_pass_filter_0.state = hpf_coeffs;
-    *high_pass_filter_1.state = hpf_coeffs;
+    // Update each of our state variable filters with the new cutoff. They
+    // all use a Q factor of 1/sqrt(2), and are therefore second order
+    // Butterworth filters. The filters also take care of the frequency
+    // pre-warping, and unlike the old dsp::IIR::Coefficients route they
+    // don't allocate, so this is safe to do on the audio thread.
+    crossover.setCutoff(sample_rate_in_hz_, cutoff_frequency_in_hz_->get());
+    crossover.setMode(
+        complementary_mode_
+            ? LinkwitzRileyCrossover<FloatType>::Mode::complementary
+            : LinkwitzRileyCrossover<FloatType>::Mode::filtered);
+
+    // Our phase compensation sections follow the later crossovers' cutoffs
+    for (auto stage = 0; stage < phase_compensation_cutoffs_.size(); stage++)
+        crossover.setPhaseCompensationCutoff(
+            stage,
+            sample_rate_in_hz_,
+            phase_compensation_cutoffs_[stage]->get());
 }
\ No newline at end of file
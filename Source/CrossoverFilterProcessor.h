@@ -6,8 +6,10 @@
     Author:  Ben Hayes
     Description:
 
-    Implements a 4th order digital Linkwitz-Riley filter using Juce's dsp::IIR
-    class.
+    Implements a 4th order digital Linkwitz-Riley crossover, using a fused
+    kernel of state variable filters (see LinkwitzRileyCrossover.h) that
+    stays accurate in single precision even for low cutoffs at high sample
+    rates.
 
   ==============================================================================
 */
@@ -15,32 +17,66 @@
 #pragma once
 
 #include "ProcessorBase.h"
+#include "LinkwitzRileyCrossover.h"
+#include "SubBlockScheduler.h"
 
 class CrossoverFilterProcessor : public ProcessorBase
 {
 public:
-    CrossoverFilterProcessor(int index);
+    CrossoverFilterProcessor(int index, float default_cutoff_in_hz = 1000.0f);
+    // Makes a crossover with filters of its own that follows an existing
+    // cutoff parameter, so that an engine can have its own crossovers
+    // without any parameters of its own. It doesn't own the parameter, so
+    // never take its parameter tree.
+    explicit CrossoverFilterProcessor(AudioParameterFloat* cutoff_frequency_in_hz);
     ~CrossoverFilterProcessor();
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
     void processBlock(
-        AudioSampleBuffer& buffer,
+        AudioBuffer<float>& buffer,
         MidiBuffer& midiMessages) override;
+    void processBlock(
+        AudioBuffer<double>& buffer,
+        MidiBuffer& midiMessages) override;
+    bool supportsDoublePrecisionProcessing() const override { return true; }
     const String getName() const override { return "Crossover Filter"; }
+    double getTailLengthSeconds() const override;
     std::unique_ptr<AudioProcessorParameterGroup> getParameterTree();
     void reset() override;
 
+    // Filter only the low side and derive the high side by subtraction.
+    // Gives the same output for about half the filtering work. Takes effect
+    // at the start of the next sub-block.
+    void setComplementaryMode(bool should_be_complementary);
+
+    // Tells this crossover that a later one in the chain splits its high
+    // output further, so that it can match that crossover's phase response
+    // on its low output. Call before prepareToPlay.
+    void addPhaseCompensationFor(const CrossoverFilterProcessor& later_crossover);
+
     AudioParameterFloat* cutoff_frequency_in_hz_;
 private:
-    dsp::ProcessorDuplicator<dsp::IIR::Filter<float>,
-                             dsp::IIR::Coefficients<float>> low_pass_filter_0;
-    dsp::ProcessorDuplicator<dsp::IIR::Filter<float>,
-                             dsp::IIR::Coefficients<float>> low_pass_filter_1;
-    dsp::ProcessorDuplicator<dsp::IIR::Filter<float>,
-                             dsp::IIR::Coefficients<float>> high_pass_filter_0;
-    dsp::ProcessorDuplicator<dsp::IIR::Filter<float>,
-                             dsp::IIR::Coefficients<float>> high_pass_filter_1;
-
-    float sample_rate_in_hz_;
-
-    void updateCoefficients();
+    // We keep one crossover kernel for each precision so that the float
+    // path is compiled exactly as before and the double path only pays for
+    // itself when the host asks for it.
+    LinkwitzRileyCrossover<float> float_crossover_;
+    LinkwitzRileyCrossover<double> double_crossover_;
+
+    double sample_rate_in_hz_;
+    SubBlockScheduler scheduler_;
+    std::atomic<bool> complementary_mode_ {false};
+    Array<AudioParameterFloat*> phase_compensation_cutoffs_;
+    bool owns_parameters_ = true;
+
+    template <typename FloatType>
+    void process(
+        AudioBuffer<FloatType>& buffer,
+        LinkwitzRileyCrossover<FloatType>& crossover);
+    template <typename FloatType>
+    void updateCoefficients(LinkwitzRileyCrossover<FloatType>& crossover);
+    template <typename FloatType>
+    void processSubBlock(
+        AudioBuffer<FloatType>& buffer,
+        LinkwitzRileyCrossover<FloatType>& crossover,
+        int start_sample,
+        int num_samples);
 };
\ No newline at end of file
@@ -0,0 +1,36 @@
+/*
+  ==============================================================================
+
+    DecibelTables.cpp
+    Created: 19 Oct 2026 1:35:11pm
+    Author:  Ben Hayes
+
+  ==============================================================================
+*/
+
+#include "DecibelTables.h"
+
+constexpr float DecibelTables::minus_infinity_db;
+constexpr float DecibelTables::min_db;
+constexpr float DecibelTables::max_db;
+constexpr float DecibelTables::steps_per_db;
+constexpr int DecibelTables::mantissa_steps;
+constexpr float DecibelTables::db_per_octave;
+
+DecibelTables::DecibelTables()
+{
+    // One entry every 0.1dB from -120dB to +60dB. Linear interpolation
+    // between them is accurate to well under a thousandth of a dB.
+    auto num_db_entries = (int) ((max_db - min_db) * steps_per_db) + 1;
+    gain_for_db_.resize((size_t) num_db_entries);
+    for (auto i = 0; i < num_db_entries; i++)
+        gain_for_db_[(size_t) i] = std::pow(
+            10.0f,
+            (min_db + (float) i / steps_per_db) / 20.0f);
+
+    // And 20.log10(m) for mantissas from 0.5 up to and including 1.0:
+    db_for_mantissa_.resize((size_t) mantissa_steps + 1);
+    for (auto i = 0; i <= mantissa_steps; i++)
+        db_for_mantissa_[(size_t) i] = 20.0f * std::log10(
+            0.5f + 0.5f * (float) i / (float) mantissa_steps);
+}
@@ -0,0 +1,80 @@
+/*
+  ==============================================================================
+
+    DecibelTables.h
+    Created: 19 Oct 2026 1:35:11pm
+    Author:  Ben Hayes
+    Description:
+
+    Lookup tables for converting between linear gain and decibels, which
+    the compressors otherwise do with a log10 and a pow for every sample.
+
+    The tables never change once they're built, so there's no reason for
+    every plugin instance to have its own copy. Hold them through a
+    SharedResourcePointer<DecibelTables>: the first instance in the process
+    builds them, every later one shares them, and they're freed when the
+    last one goes away. Since nothing ever writes to them after
+    construction, the audio thread can read them without any locking.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+
+class DecibelTables
+{
+public:
+    DecibelTables();
+
+    // Matches the default of Decibels::gainToDecibels
+    static constexpr float minus_infinity_db = -100.0f;
+
+    float decibelsToGain(float decibels) const noexcept
+    {
+        // Linearly interpolate between the two nearest entries, clamping to
+        // the ends of the table:
+        auto position = jlimit(
+            0.0f,
+            (float) (gain_for_db_.size() - 1),
+            (decibels - min_db) * steps_per_db);
+        auto index = jmin((int) position, (int) gain_for_db_.size() - 2);
+        auto fraction = position - (float) index;
+        return gain_for_db_[(size_t) index]
+            + fraction * (gain_for_db_[(size_t) index + 1]
+                          - gain_for_db_[(size_t) index]);
+    }
+
+    float gainToDecibels(float gain) const noexcept
+    {
+        if (gain <= 0.0f)
+            return minus_infinity_db;
+
+        // Split the gain into a mantissa in [0.5, 1) and a power of two.
+        // The power of two is an exact number of dB, so we only need a
+        // table for the mantissa:
+        int exponent;
+        auto mantissa = std::frexp(gain, &exponent);
+        auto position = (mantissa - 0.5f) * 2.0f * (float) mantissa_steps;
+        auto index = jmin((int) position, mantissa_steps - 1);
+        auto fraction = position - (float) index;
+        auto decibels = db_for_mantissa_[(size_t) index]
+            + fraction * (db_for_mantissa_[(size_t) index + 1]
+                          - db_for_mantissa_[(size_t) index]);
+        return jmax(minus_infinity_db, decibels + (float) exponent * db_per_octave);
+    }
+
+private:
+    static constexpr float min_db = -120.0f;
+    static constexpr float max_db = 60.0f;
+    static constexpr float steps_per_db = 10.0f;
+    static constexpr int mantissa_steps = 1024;
+    static constexpr float db_per_octave = 6.0205999f;
+
+    std::vector<float> gain_for_db_;
+    std::vector<float> db_for_mantissa_;
+
+    JUCE_DECLARE_NON_COPYABLE (DecibelTables)
+};
@@ -0,0 +1,433 @@
+/*
+  ==============================================================================
+
+    DynamicEqProcessor.cpp
+    Created: 19 Oct 2026 1:53:47pm
+    Author:  Ben Hayes
+
+  ==============================================================================
+*/
+
+#include "DynamicEqProcessor.h"
+#include "CompressorBankProcessor.h"
+
+constexpr int DynamicEqProcessor::coefficient_update_interval;
+constexpr float DynamicEqProcessor::max_gain_in_db;
+
+DynamicEqProcessor::DynamicEqProcessor(
+    const Array<CompressorProcessor*>& compressors,
+    const Array<CrossoverFilterProcessor*>& crossovers)
+    : compressors_ (compressors),
+      crossovers_ (crossovers),
+      bands_ ((size_t) compressors.size())
+{
+    // Every band sits between two crossovers, except the ones at either
+    // end, which get shelves:
+    jassert(crossovers.size() + 1 == compressors.size());
+
+    for (auto band = 0; band < compressors_.size(); band++)
+    {
+        auto& state = bands_[(size_t) band];
+        if (band == 0)
+            state.shape = Shape::low_shelf;
+        else if (band == compressors_.size() - 1)
+            state.shape = Shape::high_shelf;
+        else
+            state.shape = Shape::bell;
+
+        state.sidechain_filter.prepare(1);
+    }
+}
+
+void DynamicEqProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
+{
+    sample_rate_in_hz_ = (float) sampleRate;
+    for (auto& band : bands_)
+    {
+        // Forget our frequencies, so they're worked out again for the new
+        // sample rate
+        band.cutoff_in_hz = 0.0f;
+        band.q = 0.0f;
+        band.blend.reset(sampleRate, CompressorBankProcessor::switch_fade_in_seconds);
+    }
+    reset();
+}
+
+void DynamicEqProcessor::processBlock(
+    AudioBuffer<float>& buffer,
+    MidiBuffer& midiMessages)
+{
+    process(buffer);
+}
+
+void DynamicEqProcessor::processBlock(
+    AudioBuffer<double>& buffer,
+    MidiBuffer& midiMessages)
+{
+    process(buffer);
+}
+
+void DynamicEqProcessor::getBandRegion(
+    int band,
+    float& cutoff_in_hz,
+    float& q) const
+{
+    // The band's region is bounded by the crossovers either side of it.
+    // Shelves turn over at their one crossover, and bells are centred on
+    // the geometric mean of theirs, with a Q that spans the two.
+    q = MathConstants<float>::sqrt2 * 0.5f;
+    auto shape = bands_[(size_t) band].shape;
+    if (shape == Shape::low_shelf)
+        cutoff_in_hz = crossovers_[band]->cutoff_frequency_in_hz_->get();
+    else if (shape == Shape::high_shelf)
+        cutoff_in_hz = crossovers_[band - 1]->cutoff_frequency_in_hz_->get();
+    else
+    {
+        auto lower_in_hz = crossovers_[band - 1]->cutoff_frequency_in_hz_->get();
+        auto upper_in_hz = crossovers_[band]->cutoff_frequency_in_hz_->get();
+        cutoff_in_hz = std::sqrt(lower_in_hz * upper_in_hz);
+        q = jlimit(0.1f, 20.0f, cutoff_in_hz / std::abs(upper_in_hz - lower_in_hz));
+    }
+}
+
+double DynamicEqProcessor::getTailLengthSeconds() const
+{
+    // Only bands that are dynamic EQs ring. Their poles move with their
+    // gain, so we allow for the slowest they can get anywhere in our gain
+    // range: a bell's Q is multiplied by A = 10^(dB/40), and a shelf's
+    // corner frequency is divided by up to the square root of A. Each pole
+    // pair decays with a time constant of 2Q / (2.pi.f), and like the
+    // crossovers, we allow long enough for that to fall by 120dB.
+    auto max_a = std::pow(10.0, max_gain_in_db / 40.0);
+    auto longest_time_constant_in_seconds = 0.0;
+    for (auto band = 0; band < compressors_.size(); band++)
+    {
+        auto compressor = compressors_[band];
+        if (compressor->getBandType() != CompressorProcessor::BandType::dynamic_eq
+            || compressor->bypass_->get())
+            continue;
+
+        float cutoff_in_hz, q;
+        getBandRegion(band, cutoff_in_hz, q);
+        auto pole_q = (double) q;
+        auto pole_frequency_in_hz = (double) cutoff_in_hz;
+        if (bands_[(size_t) band].shape == Shape::bell)
+            pole_q *= max_a;
+        else
+            pole_frequency_in_hz /= std::sqrt(max_a);
+
+        longest_time_constant_in_seconds = jmax(
+            longest_time_constant_in_seconds,
+            2.0 * pole_q / (MathConstants<double>::twoPi * pole_frequency_in_hz));
+    }
+    return std::log(1.0e6) * longest_time_constant_in_seconds;
+}
+
+void DynamicEqProcessor::reset()
+{
+    for (auto& band : bands_)
+    {
+        band.sidechain_filter.reset();
+        band.gain_smoother.reset();
+        band.gain_in_db = 0.0f;
+        band.float_filter.reset();
+        band.double_filter.reset();
+        band.is_active = false;
+        band.blend.setCurrentAndTargetValue(0.0f);
+    }
+    scheduler_.reset();
+    coefficient_scheduler_.reset();
+
+    // There's nothing to fade from after a reset
+    updateParameters();
+    for (auto& band : bands_)
+        band.blend.setCurrentAndTargetValue(band.blend.getTargetValue());
+    updateCoefficients<float>(true);
+    updateCoefficients<double>(true);
+}
+
+template <typename FloatType>
+void DynamicEqProcessor::process(AudioBuffer<FloatType>& buffer)
+{
+    MBC_TIME_STAGE(performance_monitor_, performance_stage_);
+
+    // Parameters are picked up at the usual sub-block rate. Our coefficient
+    // updates divide each sub-block evenly, so the two schedulers' pieces
+    // line up.
+    scheduler_.process(
+        buffer.getNumSamples(),
+        [this, &buffer] (int start_sample, int num_samples, bool is_new_sub_block)
+        {
+            if (is_new_sub_block)
+                updateParameters();
+
+            coefficient_scheduler_.process(
+                num_samples,
+                [this, &buffer, start_sample] (
+                    int offset,
+                    int length,
+                    bool is_new_interval)
+                {
+                    if (is_new_interval)
+                        updateCoefficients<FloatType>(false);
+
+                    // Every detector hears our input before any filter
+                    // shapes it. Their levels only steer the filters from
+                    // the next interval on, so nothing waits on them.
+                    mixSidechain(buffer, start_sample + offset, length);
+                    for (auto& band : bands_)
+                        if (band.is_active)
+                            detectLevel(band, length);
+                    for (auto& band : bands_)
+                        if (band.is_active)
+                            filterBand(band, buffer, start_sample + offset, length);
+                });
+        });
+}
+
+void DynamicEqProcessor::updateParameters()
+{
+    for (auto band = 0; band < compressors_.size(); band++)
+    {
+        auto compressor = compressors_[band];
+        auto& state = bands_[(size_t) band];
+
+        auto should_be_active =
+            compressor->getBandType() == CompressorProcessor::BandType::dynamic_eq
+            && ! compressor->bypass_->get();
+        state.blend.setTargetValue(should_be_active ? 1.0f : 0.0f);
+
+        // Once we've faded out there's nothing left to do, and we start
+        // again from scratch next time:
+        auto was_active = state.is_active;
+        state.is_active = should_be_active || state.blend.isSmoothing();
+        if (! state.is_active)
+            continue;
+        if (! was_active)
+        {
+            state.sidechain_filter.reset();
+            state.gain_smoother.reset();
+            state.gain_in_db = 0.0f;
+            state.float_filter.reset();
+            state.double_filter.reset();
+        }
+
+        float cutoff_in_hz, q;
+        getBandRegion(band, cutoff_in_hz, q);
+
+        // This is the only trig we do, so only when the band has moved:
+        if (cutoff_in_hz != state.cutoff_in_hz || q != state.q)
+        {
+            state.cutoff_in_hz = cutoff_in_hz;
+            state.q = q;
+            state.g = std::tan(
+                MathConstants<double>::pi
+                * jmin(cutoff_in_hz, sample_rate_in_hz_ * 0.49f)
+                / sample_rate_in_hz_);
+            state.sidechain_filter.setCutoff(sample_rate_in_hz_, cutoff_in_hz, q);
+            state.detector_low_pass_mix =
+                state.shape == Shape::low_shelf ? 1.0f : 0.0f;
+            state.detector_band_pass_mix = state.shape == Shape::bell
+                ? state.sidechain_filter.getDamping()
+                : 0.0f;
+            state.detector_high_pass_mix =
+                state.shape == Shape::high_shelf ? 1.0f : 0.0f;
+        }
+
+        // The same curve and timing as a compressor band:
+        state.gain_computer.setParameters(
+            0,
+            compressor->threshold_in_db_->get(),
+            compressor->ratio_->get(),
+            compressor->knee_in_db_->get());
+        state.gain_computer.setLowerParameters(
+            0,
+            (GainComputer<float>::LowerMode) compressor->lower_mode_->getIndex(),
+            compressor->lower_threshold_in_db_->get(),
+            compressor->lower_ratio_->get(),
+            compressor->lower_range_in_db_->get());
+        // Our times are stored in milliseconds
+        state.gain_smoother.setTimes(
+            0,
+            sample_rate_in_hz_,
+            compressor->attack_in_seconds_->get() * 0.001f,
+            compressor->release_in_seconds_->get() * 0.001f,
+            compressor->auto_release_->get());
+    }
+}
+
+template <typename FloatType>
+void DynamicEqProcessor::updateCoefficients(bool should_jump_to_target)
+{
+    // Each active band's filter heads for the coefficients of its current
+    // gain, arriving at the end of this interval.
+    auto steps = (FloatType) coefficient_update_interval;
+    for (auto band = 0; band < compressors_.size(); band++)
+    {
+        auto& state = bands_[(size_t) band];
+        if (! state.is_active)
+            continue;
+
+        auto blend = state.blend.skip(coefficient_update_interval);
+        auto gain_in_db = blend * jlimit(
+            -max_gain_in_db,
+            max_gain_in_db,
+            compressors_[band]->makeup_gain_in_db_->get() + state.gain_in_db);
+
+        auto& filter = state.getFilter(FloatType());
+        auto target = coefficientsFor<FloatType>(state, gain_in_db);
+        auto& current = filter.coefficients;
+        auto& increments = filter.increments;
+        if (should_jump_to_target)
+        {
+            current = target;
+            increments = Coefficients<FloatType> {0, 0, 0, 0, 0, 0, 0};
+            continue;
+        }
+        increments.k = (target.k - current.k) / steps;
+        increments.a1 = (target.a1 - current.a1) / steps;
+        increments.a2 = (target.a2 - current.a2) / steps;
+        increments.a3 = (target.a3 - current.a3) / steps;
+        increments.m0 = (target.m0 - current.m0) / steps;
+        increments.m1 = (target.m1 - current.m1) / steps;
+        increments.m2 = (target.m2 - current.m2) / steps;
+    }
+}
+
+template <typename FloatType>
+DynamicEqProcessor::Coefficients<FloatType> DynamicEqProcessor::coefficientsFor(
+    const Band& band,
+    float gain_in_db) const noexcept
+{
+    // A is the square root of the linear gain, and the shelves also need
+    // its square root. Both are just fractions of the gain in dB, so they
+    // come from our table too. Everything else is worked out in the
+    // precision we're filtering in.
+    auto a = (FloatType) decibel_tables_->decibelsToGain(gain_in_db * 0.5f);
+    auto g = (FloatType) band.g;
+    auto k = (FloatType) 1 / (FloatType) band.q;
+    const auto one = (FloatType) 1;
+
+    Coefficients<FloatType> coefficients;
+    switch (band.shape)
+    {
+        case Shape::low_shelf:
+            g *= (FloatType) decibel_tables_->decibelsToGain(gain_in_db * -0.25f);
+            coefficients.m0 = one;
+            coefficients.m1 = k * (a - one);
+            coefficients.m2 = a * a - one;
+            break;
+        case Shape::bell:
+            k /= a;
+            coefficients.m0 = one;
+            coefficients.m1 = k * (a * a - one);
+            coefficients.m2 = 0;
+            break;
+        case Shape::high_shelf:
+            g *= (FloatType) decibel_tables_->decibelsToGain(gain_in_db * 0.25f);
+            coefficients.m0 = a * a;
+            coefficients.m1 = k * (one - a) * a;
+            coefficients.m2 = one - a * a;
+            break;
+    }
+
+    coefficients.k = k;
+    coefficients.a1 = one / (one + g * (g + k));
+    coefficients.a2 = g * coefficients.a1;
+    coefficients.a3 = g * coefficients.a2;
+    return coefficients;
+}
+
+template <typename FloatType>
+void DynamicEqProcessor::mixSidechain(
+    const AudioBuffer<FloatType>& buffer,
+    int start_sample,
+    int num_samples) noexcept
+{
+    // The detectors hear the mean of our channels
+    jassert(num_samples <= coefficient_update_interval);
+    auto num_channels = jmin(2, buffer.getNumChannels());
+    auto left = buffer.getReadPointer(0, start_sample);
+    if (num_channels > 1)
+    {
+        auto right = buffer.getReadPointer(1, start_sample);
+        for (auto n = 0; n < num_samples; n++)
+            sidechain_[n] = 0.5f * (float) (left[n] + right[n]);
+    }
+    else
+    {
+        for (auto n = 0; n < num_samples; n++)
+            sidechain_[n] = (float) left[n];
+    }
+}
+
+void DynamicEqProcessor::detectLevel(Band& band, int num_samples) noexcept
+{
+    // The peak level in the band's region, through the gain curve and
+    // smoothing. Only the last gain is kept, as the target for the next
+    // interval's coefficients.
+    auto low_pass_mix = band.detector_low_pass_mix;
+    auto band_pass_mix = band.detector_band_pass_mix;
+    auto high_pass_mix = band.detector_high_pass_mix;
+    for (auto n = 0; n < num_samples; n++)
+    {
+        float low_pass, band_pass, high_pass;
+        band.sidechain_filter.processSample(
+            0,
+            sidechain_[n],
+            low_pass,
+            band_pass,
+            high_pass);
+        auto detected = low_pass_mix * low_pass
+            + band_pass_mix * band_pass
+            + high_pass_mix * high_pass;
+        auto level_in_db = decibel_tables_->gainToDecibels(std::abs(detected));
+        band.gain_in_db = band.gain_smoother.process(
+            band.gain_computer.process(level_in_db));
+    }
+}
+
+template <typename FloatType>
+void DynamicEqProcessor::filterBand(
+    Band& band,
+    AudioBuffer<FloatType>& buffer,
+    int start_sample,
+    int num_samples) noexcept
+{
+    auto num_channels = jmin(2, buffer.getNumChannels());
+    auto left = buffer.getWritePointer(0, start_sample);
+    auto right = num_channels > 1
+        ? buffer.getWritePointer(1, start_sample)
+        : left;
+
+    auto& filter = band.getFilter(FloatType());
+    auto& c = filter.coefficients;
+    const auto& dc = filter.increments;
+
+    for (auto n = 0; n < num_samples; n++)
+    {
+        // Each channel, with this sample's coefficients:
+        for (auto channel = 0; channel < num_channels; channel++)
+        {
+            auto samples = channel == 0 ? left : right;
+            auto& ic1 = filter.ic1[channel];
+            auto& ic2 = filter.ic2[channel];
+
+            auto x = samples[n];
+            auto v3 = x - ic2;
+            auto v1 = c.a1 * ic1 + c.a2 * v3;
+            auto v2 = ic2 + c.a2 * ic1 + c.a3 * v3;
+            ic1 = (FloatType) 2 * v1 - ic1;
+            ic2 = (FloatType) 2 * v2 - ic2;
+            samples[n] = c.m0 * x + c.m1 * v1 + c.m2 * v2;
+        }
+
+        c.k += dc.k;
+        c.a1 += dc.a1;
+        c.a2 += dc.a2;
+        c.a3 += dc.a3;
+        c.m0 += dc.m0;
+        c.m1 += dc.m1;
+        c.m2 += dc.m2;
+    }
+}
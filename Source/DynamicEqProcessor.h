@@ -0,0 +1,196 @@
+/*
+  ==============================================================================
+
+    DynamicEqProcessor.h
+    Created: 19 Oct 2026 1:53:47pm
+    Author:  Ben Hayes
+    Description:
+
+    Lets a band act as a dynamic EQ instead of being split off and
+    compressed. The band's part of the spectrum, between the crossover
+    frequencies either side of it, is shaped in place by one filter: a low
+    shelf for the lowest band, a high shelf for the highest, and a bell
+    spanning the band for any in between. The filter's gain follows the
+    band's compressor settings, so it ducks (or with a lower mode, lifts or
+    expands) just that part of the spectrum, and the make-up gain becomes
+    a static boost.
+
+    Each band keeps the compressor's detector: its level is measured on a
+    mono sidechain, filtered to the band's region by a fixed low, band or
+    high pass, and run through the same GainComputer and GainSmoother as
+    the compressor bank. Every band detects from our input, before any of
+    the filters have shaped it, so one band's cut or boost never changes
+    how much another band reacts.
+
+    The filters are the TPT state variable filter with the bell and shelf
+    mixes from Andy Simper's "Linear Trapezoidal Integrated SVF". Their
+    gain only enters the coefficients algebraically (as A = 10^(dB/40),
+    and its square root for the shelves), and the one tan() depends only
+    on the frequency, so we only recalculate that when a crossover moves.
+    Everything else is recalculated from the smoothed gain every
+    coefficient_update_interval samples, and linearly interpolated in
+    between. The TPT structure stays well behaved while its coefficients
+    move, so this is free of zipper noise.
+
+    Bands that are compressors, or dynamic EQs that are bypassed, cost
+    nothing once they've faded out. Mute and solo still act on the band's
+    part of the spectrum in whichever multiband engine is running.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "ProcessorBase.h"
+#include "CompressorProcessor.h"
+#include "CrossoverFilterProcessor.h"
+#include "DecibelTables.h"
+#include "GainComputer.h"
+#include "GainSmoother.h"
+#include "StateVariableFilter.h"
+#include "SubBlockScheduler.h"
+#include <vector>
+
+class DynamicEqProcessor : public ProcessorBase
+{
+public:
+    // 16 samples is a third of a millisecond at 48kHz, well inside our
+    // shortest attack time.
+    static constexpr int coefficient_update_interval = 16;
+    // Past this much cut or boost, a bell or shelf is a notch or a wall
+    // anyway. Staying inside it keeps the coefficients in a comfortable
+    // range for float.
+    static constexpr float max_gain_in_db = 48.0f;
+
+    DynamicEqProcessor(
+        const Array<CompressorProcessor*>& compressors,
+        const Array<CrossoverFilterProcessor*>& crossovers);
+
+    void prepareToPlay(double sampleRate, int samplesPerBlock) override;
+    void processBlock (
+        AudioBuffer<float>& buffer,
+        MidiBuffer& midiMessages) override;
+    void processBlock (
+        AudioBuffer<double>& buffer,
+        MidiBuffer& midiMessages) override;
+    bool supportsDoublePrecisionProcessing() const override { return true; }
+    const String getName() const override { return "Dynamic EQ"; }
+    double getTailLengthSeconds() const override;
+    void reset() override;
+
+private:
+    enum class Shape
+    {
+        low_shelf,
+        bell,
+        high_shelf
+    };
+
+    // A TPT state variable filter's coefficients, plus how much of its
+    // input, band pass and low pass outputs are mixed into its output.
+    template <typename FloatType>
+    struct Coefficients
+    {
+        FloatType k = 0;
+        FloatType a1 = 0;
+        FloatType a2 = 0;
+        FloatType a3 = 0;
+        FloatType m0 = 1;
+        FloatType m1 = 0;
+        FloatType m2 = 0;
+    };
+
+    // A band's filter in one precision: where its coefficients are, how
+    // far they move each sample, and its state for each channel.
+    template <typename FloatType>
+    struct Filter
+    {
+        Coefficients<FloatType> coefficients;
+        Coefficients<FloatType> increments;
+        FloatType ic1[2] = {0, 0};
+        FloatType ic2[2] = {0, 0};
+
+        void reset() noexcept
+        {
+            ic1[0] = ic1[1] = 0;
+            ic2[0] = ic2[1] = 0;
+        }
+    };
+
+    struct Band
+    {
+        Shape shape = Shape::bell;
+        float cutoff_in_hz = 0.0f;
+        float q = 0.0f;
+        // tan(pi.fc/fs), before any shelf adjustment
+        double g = 0.0;
+
+        StateVariableFilter<float> sidechain_filter;
+        // How much of the sidechain filter's low, band and high pass
+        // outputs the detector hears. Only the one for our shape is
+        // non-zero, and the band pass is scaled to unity gain at its
+        // centre.
+        float detector_low_pass_mix = 0.0f;
+        float detector_band_pass_mix = 0.0f;
+        float detector_high_pass_mix = 0.0f;
+        GainComputer<float> gain_computer;
+        GainSmoother<float> gain_smoother;
+        float gain_in_db = 0.0f;
+
+        // 1 while the band is a dynamic EQ, 0 otherwise. Scales the gain,
+        // so switching fades the filter in and out.
+        SmoothedValue<float> blend;
+        bool is_active = false;
+
+        // Like the crossovers, we keep a filter for each precision, so the
+        // double path filters natively. The detector above is a control
+        // signal, so it always runs in float.
+        Filter<float> float_filter;
+        Filter<double> double_filter;
+
+        Filter<float>& getFilter(float) noexcept { return float_filter; }
+        Filter<double>& getFilter(double) noexcept { return double_filter; }
+    };
+
+    template <typename FloatType>
+    void process(AudioBuffer<FloatType>& buffer);
+    void updateParameters();
+    void getBandRegion(int band, float& cutoff_in_hz, float& q) const;
+    template <typename FloatType>
+    void updateCoefficients(bool should_jump_to_target);
+    template <typename FloatType>
+    Coefficients<FloatType> coefficientsFor(
+        const Band& band,
+        float gain_in_db) const noexcept;
+    template <typename FloatType>
+    void mixSidechain(
+        const AudioBuffer<FloatType>& buffer,
+        int start_sample,
+        int num_samples) noexcept;
+    void detectLevel(Band& band, int num_samples) noexcept;
+    template <typename FloatType>
+    void filterBand(
+        Band& band,
+        AudioBuffer<FloatType>& buffer,
+        int start_sample,
+        int num_samples) noexcept;
+
+    Array<CompressorProcessor*> compressors_;
+    Array<CrossoverFilterProcessor*> crossovers_;
+    std::vector<Band> bands_;
+
+    float sample_rate_in_hz_ = 44100.0f;
+    // Parameters are picked up every sub-block, and the filters follow
+    // their gains every coefficient update interval within that.
+    SubBlockScheduler scheduler_;
+    SubBlockScheduler coefficient_scheduler_ {coefficient_update_interval};
+    // The mono input for one coefficient update interval, which every
+    // band's detector reads before any band's filter touches the audio
+    float sidechain_[coefficient_update_interval] = {};
+
+    // Shared with the compressor bank, and with every other instance in
+    // the process
+    SharedResourcePointer<DecibelTables> decibel_tables_;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DynamicEqProcessor)
+};
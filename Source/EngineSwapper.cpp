@@ -0,0 +1,300 @@
+/*
+  ==============================================================================
+
+    EngineSwapper.cpp
+    Created: 19 Oct 2026 2:02:40pm
+    Author:  Ben Hayes
+
+  ==============================================================================
+*/
+
+#include "EngineSwapper.h"
+
+constexpr double EngineSwapper::crossfade_in_seconds;
+constexpr int EngineSwapper::retire_delay_in_ms;
+constexpr int EngineSwapper::max_retired_engines;
+
+EngineSwapper::EngineSwapper(
+    EngineChooser choose_engine,
+    EngineFactory create_engine,
+    LatencyCallback set_latency)
+    : Thread ("Engine Builder"),
+      choose_engine_ (std::move(choose_engine)),
+      create_engine_ (std::move(create_engine)),
+      set_latency_ (std::move(set_latency))
+{
+}
+
+EngineSwapper::~EngineSwapper()
+{
+    release();
+}
+
+void EngineSwapper::prepare(
+    double sample_rate_in_hz,
+    int max_block_size,
+    bool use_double_precision)
+{
+    // We're not processing, so we can throw away whatever engines we had
+    // and build the one the plugin wants right here:
+    release();
+
+    sample_rate_in_hz_ = sample_rate_in_hz;
+    max_block_size_ = max_block_size;
+    use_double_precision_ = use_double_precision;
+    crossfade_length_ = jmax(1, roundToInt(crossfade_in_seconds * sample_rate_in_hz));
+
+    auto engine_id = choose_engine_();
+    active_engine_ = createEngine(engine_id);
+    engine_id_ = engine_id;
+    latency_in_samples_ = active_engine_->getLatencySamples();
+    set_latency_(latency_in_samples_.load());
+
+    // The old engine's output only needs to hold one host block at a time
+    // while we crossfade. Bigger blocks are crossfaded a piece at a time.
+    auto scratch_size = jmax(1, max_block_size);
+    if (use_double_precision)
+        double_scratch_.setSize(2, scratch_size);
+    else
+        float_scratch_.setSize(2, scratch_size);
+
+    startThread();
+}
+
+void EngineSwapper::release()
+{
+    stopThread(10000);
+    cancelPendingUpdate();
+    deleteAllEngines();
+    float_scratch_.setSize(0, 0);
+    double_scratch_.setSize(0, 0);
+}
+
+void EngineSwapper::deleteAllEngines()
+{
+    // Only called with the builder thread stopped and the audio thread
+    // idle, so everything is ours to delete.
+    delete pending_engine_.exchange(nullptr);
+    delete active_engine_;
+    delete fading_engine_;
+    active_engine_ = nullptr;
+    fading_engine_ = nullptr;
+    crossfade_position_ = 0;
+    freeRetiredEngines();
+}
+
+MultibandEngine* EngineSwapper::createEngine(int engine_id)
+{
+    auto engine = create_engine_(engine_id);
+    engine->prepare(sample_rate_in_hz_, max_block_size_, use_double_precision_);
+    return engine.release();
+}
+
+void EngineSwapper::freeRetiredEngines()
+{
+    int start_1, size_1, start_2, size_2;
+    retired_fifo_.prepareToRead(
+        retired_fifo_.getNumReady(),
+        start_1,
+        size_1,
+        start_2,
+        size_2);
+    for (auto i = 0; i < size_1; i++)
+        delete retired_engines_[(size_t) (start_1 + i)];
+    for (auto i = 0; i < size_2; i++)
+        delete retired_engines_[(size_t) (start_2 + i)];
+    retired_fifo_.finishedRead(size_1 + size_2);
+}
+
+void EngineSwapper::run()
+{
+    while (! threadShouldExit())
+    {
+        freeRetiredEngines();
+
+        // If the plugin wants a different engine from the last one we
+        // published, we build and prepare it here, where allocating and
+        // taking locks is fine, then publish it. Should the audio thread
+        // not have picked up the last one yet, we take that back.
+        auto engine_id = choose_engine_();
+        if (engine_id != engine_id_.load())
+        {
+            auto engine = createEngine(engine_id);
+            auto latency_in_samples = engine->getLatencySamples();
+            delete pending_engine_.exchange(engine);
+            engine_id_ = engine_id;
+            latency_in_samples_ = latency_in_samples;
+            triggerAsyncUpdate();
+
+            // The engine this one replaces is retired once it has faded
+            // out, so we come back round shortly to delete it. If the host
+            // isn't playing, it waits until the next swap or release.
+            wait(retire_delay_in_ms);
+            continue;
+        }
+
+        // Nothing to do until the plugin's choice of engine changes
+        wait(-1);
+    }
+}
+
+void EngineSwapper::handleAsyncUpdate()
+{
+    // We get here both when the plugin's choice of engine may have
+    // changed, and when the builder thread has published a new engine.
+    // Waking the builder thread the second time just finds nothing to do.
+    notify();
+    set_latency_(latency_in_samples_.load());
+}
+
+bool EngineSwapper::canRetireEngines(int num_engines) const noexcept
+{
+    return retired_fifo_.getFreeSpace() >= num_engines;
+}
+
+void EngineSwapper::retireEngine(MultibandEngine* engine) noexcept
+{
+    // We never pick up an engine without room to retire it later, so this
+    // always has space.
+    int start_1, size_1, start_2, size_2;
+    retired_fifo_.prepareToWrite(1, start_1, size_1, start_2, size_2);
+    jassert(size_1 + size_2 == 1);
+    retired_engines_[(size_t) (size_1 > 0 ? start_1 : start_2)] = engine;
+    retired_fifo_.finishedWrite(size_1 + size_2);
+}
+
+void EngineSwapper::pickUpPendingEngine() noexcept
+{
+    // A new engine may need to retire the one we're already fading out
+    // straight away, and the one it's replacing once it's faded in. If the
+    // builder thread has fallen behind on deleting them, the new engine
+    // can wait for a block or two.
+    if (! canRetireEngines(2))
+        return;
+
+    auto engine = pending_engine_.exchange(nullptr);
+    if (engine == nullptr)
+        return;
+
+    // If we were still fading between two engines, the older one goes now
+    // and we start a fresh crossfade from the one that was fading in. That
+    // only happens if the plugin changes its mind within a few
+    // milliseconds, so the small jump it makes doesn't matter.
+    if (fading_engine_ != nullptr)
+        retireEngine(fading_engine_);
+    fading_engine_ = active_engine_;
+    active_engine_ = engine;
+    crossfade_position_ = 0;
+}
+
+void EngineSwapper::reset()
+{
+    if (fading_engine_ != nullptr)
+    {
+        retireEngine(fading_engine_);
+        fading_engine_ = nullptr;
+    }
+    if (active_engine_ != nullptr)
+        active_engine_->reset();
+}
+
+void EngineSwapper::process(AudioBuffer<float>& buffer)
+{
+    process(buffer, float_scratch_);
+}
+
+void EngineSwapper::process(AudioBuffer<double>& buffer)
+{
+    process(buffer, double_scratch_);
+}
+
+template <typename FloatType>
+void EngineSwapper::process(
+    AudioBuffer<FloatType>& buffer,
+    AudioBuffer<FloatType>& scratch)
+{
+    pickUpPendingEngine();
+    if (active_engine_ == nullptr)
+        return;
+
+    auto num_channels = jmin(2, buffer.getNumChannels());
+    auto num_samples = buffer.getNumSamples();
+    auto start_sample = 0;
+
+    // While we're crossfading, we run both engines over as much of the
+    // buffer as the crossfade and our scratch buffer allow...
+    while (fading_engine_ != nullptr && start_sample < num_samples)
+    {
+        auto num_fade_samples = jmin(
+            num_samples - start_sample,
+            crossfade_length_ - crossfade_position_,
+            scratch.getNumSamples());
+        crossfade(buffer, scratch, start_sample, num_fade_samples);
+        start_sample += num_fade_samples;
+
+        if (crossfade_position_ >= crossfade_length_)
+        {
+            retireEngine(fading_engine_);
+            fading_engine_ = nullptr;
+        }
+    }
+
+    // ...and the rest only goes through the new one.
+    if (start_sample == 0)
+    {
+        active_engine_->process(buffer);
+    }
+    else if (start_sample < num_samples)
+    {
+        AudioBuffer<FloatType> rest(
+            buffer.getArrayOfWritePointers(),
+            num_channels,
+            start_sample,
+            num_samples - start_sample);
+        active_engine_->process(rest);
+    }
+}
+
+template <typename FloatType>
+void EngineSwapper::crossfade(
+    AudioBuffer<FloatType>& buffer,
+    AudioBuffer<FloatType>& scratch,
+    int start_sample,
+    int num_samples)
+{
+    auto num_channels = jmin(2, buffer.getNumChannels());
+
+    // The old engine gets its own copy of the input. Views onto the
+    // buffers just point into them, so making them doesn't allocate.
+    for (auto channel = 0; channel < num_channels; channel++)
+        scratch.copyFrom(channel, 0, buffer, channel, start_sample, num_samples);
+    AudioBuffer<FloatType> new_output(
+        buffer.getArrayOfWritePointers(),
+        num_channels,
+        start_sample,
+        num_samples);
+    AudioBuffer<FloatType> old_output(
+        scratch.getArrayOfWritePointers(),
+        num_channels,
+        0,
+        num_samples);
+    active_engine_->process(new_output);
+    fading_engine_->process(old_output);
+
+    // Both engines are processing the same input, so their outputs are
+    // strongly correlated and a linear crossfade keeps the level steady.
+    auto start_gain = (FloatType) crossfade_position_ / (FloatType) crossfade_length_;
+    crossfade_position_ += num_samples;
+    auto end_gain = (FloatType) crossfade_position_ / (FloatType) crossfade_length_;
+    for (auto channel = 0; channel < num_channels; channel++)
+    {
+        buffer.applyGainRamp(channel, start_sample, num_samples, start_gain, end_gain);
+        buffer.addFromWithRamp(
+            channel,
+            start_sample,
+            scratch.getReadPointer(channel),
+            num_samples,
+            (FloatType) 1 - start_gain,
+            (FloatType) 1 - end_gain);
+    }
+}
@@ -0,0 +1,146 @@
+/*
+  ==============================================================================
+
+    EngineSwapper.h
+    Created: 19 Oct 2026 2:02:40pm
+    Author:  Ben Hayes
+    Description:
+
+    Swaps the plugin's multiband engine while it plays, without the audio
+    thread ever taking a lock, allocating or freeing anything.
+
+    A builder thread sleeps until the plugin tells us which engine it
+    wants may have changed. If it has, the thread builds and prepares the
+    new engine itself, and hands it to the audio thread through an atomic
+    pointer. The audio thread
+    picks it up at the start of its next block and crossfades from the old
+    engine to the new one over a few milliseconds, running both in the
+    meantime. Once the old engine has faded out, the audio thread retires
+    it into a lock-free queue, and the builder thread deletes it when it
+    checks back shortly afterwards. Between swaps the thread is blocked
+    and costs nothing, however many instances are loaded.
+
+    The engines have different latencies, which the host can only be told
+    about from the message thread, so we report each new engine's latency
+    from there as soon as it's built. The crossfade covers the jump.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "MultibandEngine.h"
+#include <array>
+
+class EngineSwapper : private Thread,
+                      private AsyncUpdater
+{
+public:
+    // Which engine the plugin wants right now. Called on the builder
+    // thread, so it should only read parameters.
+    using EngineChooser = std::function<int()>;
+    // Builds a new, unprepared engine of the given kind. Called on the
+    // builder thread, or the message thread while we're being prepared.
+    using EngineFactory = std::function<std::unique_ptr<MultibandEngine>(int)>;
+    // Tells the host about a new latency. Always called on the message
+    // thread.
+    using LatencyCallback = std::function<void(int)>;
+
+    // Long enough to hide the switch, short enough that we're only running
+    // two engines for a handful of blocks.
+    static constexpr double crossfade_in_seconds = 0.01;
+    // How long after publishing an engine the builder thread checks back
+    // to delete the one it replaced: comfortably longer than the
+    // crossfade plus a host block or two
+    static constexpr int retire_delay_in_ms = 100;
+    // Room for engines waiting to be deleted. We only pick up a new engine
+    // when there's room to retire two, so this is plenty.
+    static constexpr int max_retired_engines = 16;
+
+    EngineSwapper(
+        EngineChooser choose_engine,
+        EngineFactory create_engine,
+        LatencyCallback set_latency);
+    ~EngineSwapper();
+
+    // Builds the chosen engine straight away and starts the builder
+    // thread. Never called while we're processing.
+    void prepare(
+        double sample_rate_in_hz,
+        int max_block_size,
+        bool use_double_precision);
+    // Stops the builder thread and deletes every engine
+    void release();
+    // Clears the playing engine's state and drops any crossfade. Safe on
+    // the audio thread.
+    void reset();
+
+    void process(AudioBuffer<float>& buffer);
+    void process(AudioBuffer<double>& buffer);
+
+    // Call whenever the engine the chooser picks may have changed. Safe on
+    // any thread: the builder thread is woken from the message thread.
+    void chosenEngineMayHaveChanged() { triggerAsyncUpdate(); }
+
+    // The kind of engine that's playing, or fading in, and its latency
+    int getEngineId() const noexcept { return engine_id_.load(); }
+    int getLatencySamples() const noexcept { return latency_in_samples_.load(); }
+
+private:
+    void run() override;
+    void handleAsyncUpdate() override;
+
+    MultibandEngine* createEngine(int engine_id);
+    void deleteAllEngines();
+    void freeRetiredEngines();
+    bool canRetireEngines(int num_engines) const noexcept;
+    void retireEngine(MultibandEngine* engine) noexcept;
+    void pickUpPendingEngine() noexcept;
+
+    template <typename FloatType>
+    void process(AudioBuffer<FloatType>& buffer, AudioBuffer<FloatType>& scratch);
+    template <typename FloatType>
+    void crossfade(
+        AudioBuffer<FloatType>& buffer,
+        AudioBuffer<FloatType>& scratch,
+        int start_sample,
+        int num_samples);
+
+    EngineChooser choose_engine_;
+    EngineFactory create_engine_;
+    LatencyCallback set_latency_;
+
+    // Written by prepare() while the builder thread is stopped, and only
+    // read after that
+    double sample_rate_in_hz_ = 44100.0;
+    int max_block_size_ = 0;
+    bool use_double_precision_ = false;
+
+    // The latest engine the builder thread has published
+    std::atomic<int> engine_id_ {-1};
+    std::atomic<int> latency_in_samples_ {0};
+
+    // Handed from the builder thread to the audio thread. If the audio
+    // thread hasn't picked it up by the time the builder has another one,
+    // the builder takes it back and deletes it.
+    std::atomic<MultibandEngine*> pending_engine_ {nullptr};
+
+    // Only ever touched by the audio thread, or while it's stopped
+    MultibandEngine* active_engine_ = nullptr;
+    MultibandEngine* fading_engine_ = nullptr;
+    int crossfade_length_ = 0;
+    int crossfade_position_ = 0;
+
+    // The old engine's output while we crossfade. Only the one for the
+    // precision we're processing in is allocated.
+    AudioBuffer<float> float_scratch_;
+    AudioBuffer<double> double_scratch_;
+
+    // Engines the audio thread is done with, waiting for the builder
+    // thread to delete them
+    AbstractFifo retired_fifo_ {max_retired_engines};
+    std::array<MultibandEngine*, max_retired_engines> retired_engines_ {};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (EngineSwapper)
+};
@@ -0,0 +1,148 @@
+/*
+  ==============================================================================
+
+    GainComputer.h
+    Created: 19 Oct 2026 1:41:12pm
+    Author:  Ben Hayes
+    Description:
+
+    The static curve of a compressor: given the detected level in dB, how
+    much gain (in dB, before any smoothing or make-up) to apply. Uses the
+    soft knee from Giannoulis, Massberg and Reiss, "Digital Dynamic Range
+    Compressor Design - A Tutorial and Analysis".
+
+    The usual implementation picks one of three formulas depending on
+    whether we're below, inside or above the knee. Here the three regions
+    are folded into one expression using min and max, so that it can run
+    across bands in SIMD lanes as well as on a single float:
+
+        t    = clamp(over + knee/2, 0, knee)
+        gain = slope * (t^2 / (2 knee) + max(over - knee/2, 0))
+
+    where over is the level over the threshold and slope = 1/ratio - 1.
+    Below the knee both terms are zero, inside it only the first applies,
+    and above it the first term is a constant knee/2 that makes up the
+    difference between over and over - knee/2.
+
+    Below a second, lower threshold the curve can also bend the other way,
+    either compressing upwards (quiet material is brought up) or expanding
+    downwards (quiet material is pushed further down, up to a gate). That
+    uses the mirror image of the same knee:
+
+        u     = clamp(under - knee/2, -knee, 0)
+        gain += clamp(lower_slope * (min(under + knee/2, 0) - u^2 / (2 knee)),
+                      -range, range)
+
+    where under is the level relative to the lower threshold. The lower
+    slope is 1/ratio - 1 for upward compression and ratio - 1 for
+    expansion, and range limits how far either can go, so that upward
+    compression doesn't bring the noise floor up without limit. With the
+    lower curve off, its slope is zero and it adds nothing.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "LaneOps.h"
+
+template <typename Lanes>
+class GainComputer
+{
+public:
+    using Ops = LaneOps<Lanes>;
+
+    enum class LowerMode
+    {
+        off = 0,
+        upward_compression,
+        expansion
+    };
+
+    GainComputer()
+    {
+        auto zero = Ops::broadcast(0.0f);
+        threshold_in_db_ = zero;
+        slope_ = zero;
+        half_knee_in_db_ = zero;
+        knee_scale_ = zero;
+        lower_threshold_in_db_ = zero;
+        lower_slope_ = zero;
+        lower_range_in_db_ = zero;
+    }
+
+    // Sets the curve of one lane. Lanes we never set have a slope of zero,
+    // so they never ask for any gain change.
+    void setParameters(
+        size_t lane,
+        float threshold_in_db,
+        float ratio,
+        float knee_in_db) noexcept
+    {
+        Ops::set(threshold_in_db_, lane, threshold_in_db);
+        Ops::set(slope_, lane, 1.0f / ratio - 1.0f);
+        Ops::set(half_knee_in_db_, lane, knee_in_db * 0.5f);
+        // With no knee, t is always zero, so any finite scale will do:
+        Ops::set(
+            knee_scale_,
+            lane,
+            knee_in_db > 0.0f ? 0.5f / knee_in_db : 0.0f);
+    }
+
+    // Sets the curve of one lane below its lower threshold. Shares its
+    // knee with the upper curve.
+    void setLowerParameters(
+        size_t lane,
+        LowerMode mode,
+        float threshold_in_db,
+        float ratio,
+        float range_in_db) noexcept
+    {
+        auto slope = 0.0f;
+        if (mode == LowerMode::upward_compression)
+            slope = 1.0f / ratio - 1.0f;
+        else if (mode == LowerMode::expansion)
+            slope = ratio - 1.0f;
+
+        Ops::set(lower_threshold_in_db_, lane, threshold_in_db);
+        Ops::set(lower_slope_, lane, slope);
+        Ops::set(lower_range_in_db_, lane, range_in_db);
+    }
+
+    Lanes process(Lanes level_in_db) const noexcept
+    {
+        auto zero = Ops::broadcast(0.0f);
+        auto knee_in_db = half_knee_in_db_ + half_knee_in_db_;
+
+        auto over = level_in_db - threshold_in_db_;
+        auto into_knee = Ops::minimum(
+            Ops::maximum(over + half_knee_in_db_, zero),
+            knee_in_db);
+        auto upper_gain_in_db = slope_
+            * (into_knee * into_knee * knee_scale_
+               + Ops::maximum(over - half_knee_in_db_, zero));
+
+        auto under = level_in_db - lower_threshold_in_db_;
+        auto under_knee = Ops::maximum(
+            Ops::minimum(under - half_knee_in_db_, zero),
+            zero - knee_in_db);
+        auto lower_gain_in_db = Ops::minimum(
+            Ops::maximum(
+                lower_slope_
+                    * (Ops::minimum(under + half_knee_in_db_, zero)
+                       - under_knee * under_knee * knee_scale_),
+                zero - lower_range_in_db_),
+            lower_range_in_db_);
+
+        return upper_gain_in_db + lower_gain_in_db;
+    }
+
+private:
+    Lanes threshold_in_db_;
+    Lanes slope_;
+    Lanes half_knee_in_db_;
+    Lanes knee_scale_;
+    Lanes lower_threshold_in_db_;
+    Lanes lower_slope_;
+    Lanes lower_range_in_db_;
+};
@@ -0,0 +1,208 @@
+/*
+  ==============================================================================
+
+    GainSmoother.h
+    Created: 19 Oct 2026 1:38:38pm
+    Author:  Ben Hayes
+    Description:
+
+    Attack/release ballistics for a compressor's gain signal (in dB), with
+    an optional program-dependent "auto" release.
+
+    Auto release works like the dual time constant release of classic bus
+    compressors. Two envelopes follow the gain: a fast one with the normal
+    attack and release times, and a slow one that only charges up over the
+    release time and lets go five times more slowly. We use whichever gives
+    more gain reduction. A short transient barely moves the slow envelope,
+    so it recovers at the fast rate and doesn't pump, while sustained
+    compression charges the slow envelope up and releases gently.
+
+    The kernel is branch-free: rather than testing whether each envelope is
+    attacking or releasing, we split the step towards the target into its
+    negative and positive parts with min and max, and scale each by its own
+    coefficient. That means the same code can run on a plain float, or on a
+    dsp::SIMDRegister<float> with one band in each lane, where the lanes
+    could never agree on a branch anyway.
+
+    The envelopes can also be advanced at a control rate, once every K
+    samples. Decimating the input instead (by peak or average) gets the
+    attack badly wrong, since every sample over the envelope pulls it down,
+    not just the loudest. So instead we hold the envelopes still for the
+    interval, accumulate every sample's step towards its target with
+    accumulate(), and then take all of them at once with advance(), using
+    coefficients for K samples' worth of movement. The only serial
+    dependency left is from one interval to the next. With K = 1 this is
+    exactly process().
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "LaneOps.h"
+
+template <typename Lanes>
+class GainSmoother
+{
+public:
+    // How many times longer sustained compression takes to release than
+    // transients do, in auto release mode.
+    static constexpr float slow_release_factor = 5.0f;
+
+    using Ops = LaneOps<Lanes>;
+
+    GainSmoother()
+    {
+        auto zero = Ops::broadcast(0.0f);
+        attack_ = zero;
+        release_ = zero;
+        slow_attack_ = zero;
+        slow_release_ = zero;
+        auto_release_ = zero;
+        reset();
+    }
+
+    // Sets the timing of one lane. Call at control rate: it takes a few
+    // exps per lane. Lanes that are advanced once per interval of several
+    // samples need to know how many.
+    void setTimes(
+        size_t lane,
+        float sample_rate_in_hz,
+        float attack_in_seconds,
+        float release_in_seconds,
+        bool auto_release,
+        int interval_in_samples = 1) noexcept
+    {
+        Ops::set(
+            attack_,
+            lane,
+            coefficientFor(attack_in_seconds, sample_rate_in_hz, interval_in_samples));
+        Ops::set(
+            release_,
+            lane,
+            coefficientFor(release_in_seconds, sample_rate_in_hz, interval_in_samples));
+        Ops::set(
+            slow_attack_,
+            lane,
+            coefficientFor(release_in_seconds, sample_rate_in_hz, interval_in_samples));
+        Ops::set(
+            slow_release_,
+            lane,
+            coefficientFor(
+                release_in_seconds * slow_release_factor,
+                sample_rate_in_hz,
+                interval_in_samples));
+        Ops::set(auto_release_, lane, auto_release ? 1.0f : 0.0f);
+    }
+
+    void reset() noexcept
+    {
+        auto zero = Ops::broadcast(0.0f);
+        fast_ = zero;
+        slow_ = zero;
+        fast_attack_steps_ = zero;
+        fast_release_steps_ = zero;
+        slow_attack_steps_ = zero;
+        slow_release_steps_ = zero;
+    }
+
+    void resetLane(size_t lane) noexcept
+    {
+        Ops::set(fast_, lane, 0.0f);
+        Ops::set(slow_, lane, 0.0f);
+        Ops::set(fast_attack_steps_, lane, 0.0f);
+        Ops::set(fast_release_steps_, lane, 0.0f);
+        Ops::set(slow_attack_steps_, lane, 0.0f);
+        Ops::set(slow_release_steps_, lane, 0.0f);
+    }
+
+    // Advances every lane's envelopes by one sample towards gain_in_db, and
+    // returns the smoothed gain.
+    Lanes process(Lanes gain_in_db) noexcept
+    {
+        auto zero = Ops::broadcast(0.0f);
+
+        // A falling gain means more gain reduction, so it's the attack
+        // coefficient that scales the negative part of the step:
+        auto step = gain_in_db - fast_;
+        fast_ = fast_
+            + attack_ * Ops::minimum(step, zero)
+            + release_ * Ops::maximum(step, zero);
+
+        step = gain_in_db - slow_;
+        slow_ = slow_
+            + slow_attack_ * Ops::minimum(step, zero)
+            + slow_release_ * Ops::maximum(step, zero);
+
+        // Blending rather than branching keeps lanes with auto release off
+        // on exactly the fast envelope:
+        return fast_ + auto_release_ * (Ops::minimum(fast_, slow_) - fast_);
+    }
+
+    // Adds one sample's steps towards gain_in_db to the current interval,
+    // without moving the envelopes.
+    void accumulate(Lanes gain_in_db) noexcept
+    {
+        auto zero = Ops::broadcast(0.0f);
+
+        auto step = gain_in_db - fast_;
+        fast_attack_steps_ = fast_attack_steps_ + Ops::minimum(step, zero);
+        fast_release_steps_ = fast_release_steps_ + Ops::maximum(step, zero);
+
+        step = gain_in_db - slow_;
+        slow_attack_steps_ = slow_attack_steps_ + Ops::minimum(step, zero);
+        slow_release_steps_ = slow_release_steps_ + Ops::maximum(step, zero);
+    }
+
+    // Moves the envelopes on by the whole interval accumulated so far, and
+    // returns the smoothed gain at its end.
+    Lanes advance() noexcept
+    {
+        auto zero = Ops::broadcast(0.0f);
+
+        fast_ = fast_
+            + attack_ * fast_attack_steps_
+            + release_ * fast_release_steps_;
+        slow_ = slow_
+            + slow_attack_ * slow_attack_steps_
+            + slow_release_ * slow_release_steps_;
+
+        fast_attack_steps_ = zero;
+        fast_release_steps_ = zero;
+        slow_attack_steps_ = zero;
+        slow_release_steps_ = zero;
+
+        return fast_ + auto_release_ * (Ops::minimum(fast_, slow_) - fast_);
+    }
+
+private:
+    // The fraction of the way to the target we move each sample, for a time
+    // constant taking us 1 - 1/e of the way there. Over an interval we move
+    // as far as that many samples would take us, shared out between the
+    // interval's accumulated steps.
+    static float coefficientFor(
+        float time_in_seconds,
+        float sample_rate_in_hz,
+        int interval_in_samples) noexcept
+    {
+        return (1.0f - std::exp(
+                   -(float) interval_in_samples
+                   / (time_in_seconds * sample_rate_in_hz)))
+            / (float) interval_in_samples;
+    }
+
+    Lanes attack_;
+    Lanes release_;
+    Lanes slow_attack_;
+    Lanes slow_release_;
+    Lanes auto_release_;
+
+    Lanes fast_;
+    Lanes slow_;
+
+    // Steps accumulated over the current control interval
+    Lanes fast_attack_steps_;
+    Lanes fast_release_steps_;
+    Lanes slow_attack_steps_;
+    Lanes slow_release_steps_;
+};
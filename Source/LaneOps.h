@@ -0,0 +1,75 @@
+/*
+  ==============================================================================
+
+    LaneOps.h
+    Created: 19 Oct 2026 1:41:12pm
+    Author:  Ben Hayes
+    Description:
+
+    The few operations our per-band control kernels need that are spelled
+    differently for a plain float and a dsp::SIMDRegister. Kernels written
+    against LaneOps<Lanes> run on either: one band at a time on a float, or
+    one band in each lane of a SIMD register.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+template <typename Lanes>
+struct LaneOps;
+
+// Allocates room for num_elements of Type in memory, starting on a SIMD
+// register boundary, and returns a pointer to the first one. Neither new
+// nor HeapBlock promise more than the platform's default alignment, so we
+// over-allocate and align by hand. Doesn't construct anything.
+template <typename Type>
+Type* allocateRegisterAligned(HeapBlock<char>& memory, size_t num_elements)
+{
+    auto alignment = dsp::SIMDRegister<float>::SIMDRegisterSize;
+    memory.allocate(sizeof(Type) * num_elements + alignment, false);
+    auto misalignment = (size_t) ((pointer_sized_uint) memory.get() % alignment);
+    return reinterpret_cast<Type*>(
+        memory.get() + (misalignment == 0 ? 0 : alignment - misalignment));
+}
+
+template <>
+struct LaneOps<float>
+{
+    static constexpr size_t num_lanes = 1;
+
+    static float broadcast(float value) noexcept { return value; }
+    static float minimum(float a, float b) noexcept { return jmin(a, b); }
+    static float maximum(float a, float b) noexcept { return jmax(a, b); }
+    static void set(float& lanes, size_t, float value) noexcept
+    {
+        lanes = value;
+    }
+};
+
+template <typename ElementType>
+struct LaneOps<dsp::SIMDRegister<ElementType>>
+{
+    using Register = dsp::SIMDRegister<ElementType>;
+
+    static constexpr size_t num_lanes = Register::SIMDNumElements;
+
+    static Register broadcast(ElementType value) noexcept
+    {
+        return Register::expand(value);
+    }
+    static Register minimum(Register a, Register b) noexcept
+    {
+        return Register::min(a, b);
+    }
+    static Register maximum(Register a, Register b) noexcept
+    {
+        return Register::max(a, b);
+    }
+    static void set(Register& lanes, size_t lane, ElementType value) noexcept
+    {
+        lanes.set(lane, value);
+    }
+};
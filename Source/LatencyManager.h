@@ -0,0 +1,103 @@
+/*
+  ==============================================================================
+
+    LatencyManager.h
+    Created: 19 Oct 2026 1:45:14pm
+    Author:  Ben Hayes
+    Description:
+
+    Keeps the bands of the multiband process lined up in time. Given the
+    latency of the path each band takes through the crossovers and the
+    compressor bank, it works out the smallest total latency that lets
+    every band come out together (that of the slowest band), and delays
+    every other band by the difference before they're summed.
+
+    Delay lines are preallocated in prepare(), and only for the bands that
+    need one. While every stage is latency free, as all of ours currently
+    are, no delay lines are allocated and process() does nothing.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "BandBufferStore.h"
+#include <vector>
+
+template <typename FloatType>
+class LatencyManager
+{
+public:
+    // Allocates, so never call it on the audio thread.
+    void prepare(const Array<int>& band_latencies, int num_channels_per_band)
+    {
+        latency_in_samples_ = 0;
+        for (auto latency : band_latencies)
+            latency_in_samples_ = jmax(latency_in_samples_, latency);
+
+        delay_lines_.clear();
+        for (auto band = 0; band < band_latencies.size(); band++)
+        {
+            auto delay = latency_in_samples_ - band_latencies[band];
+            if (delay == 0)
+                continue;
+
+            for (auto channel = 0; channel < num_channels_per_band; channel++)
+            {
+                DelayLine delay_line;
+                delay_line.band = band;
+                delay_line.channel = channel;
+                delay_line.samples.assign((size_t) delay, FloatType());
+                delay_lines_.push_back(std::move(delay_line));
+            }
+        }
+    }
+
+    int getLatencySamples() const noexcept { return latency_in_samples_; }
+
+    void reset() noexcept
+    {
+        for (auto& delay_line : delay_lines_)
+        {
+            std::fill(
+                delay_line.samples.begin(),
+                delay_line.samples.end(),
+                FloatType());
+            delay_line.position = 0;
+        }
+    }
+
+    // Delays each band that needs it, in place
+    void process(const BandBufferStore<FloatType>& bands, int num_samples) noexcept
+    {
+        for (auto& delay_line : delay_lines_)
+        {
+            auto samples = bands.getWritePointer(
+                delay_line.band,
+                delay_line.channel);
+            auto length = (int) delay_line.samples.size();
+            auto position = delay_line.position;
+
+            for (auto n = 0; n < num_samples; n++)
+            {
+                std::swap(samples[n], delay_line.samples[(size_t) position]);
+                if (++position == length)
+                    position = 0;
+            }
+
+            delay_line.position = position;
+        }
+    }
+
+private:
+    struct DelayLine
+    {
+        int band = 0;
+        int channel = 0;
+        int position = 0;
+        std::vector<FloatType> samples;
+    };
+
+    int latency_in_samples_ = 0;
+    std::vector<DelayLine> delay_lines_;
+};
@@ -0,0 +1,202 @@
+/*
+  ==============================================================================
+
+    LinkwitzRileyCrossover.h
+    Created: 19 Oct 2026 1:31:25pm
+    Author:  Ben Hayes
+    Description:
+
+    A fused 4th order Linkwitz-Riley crossover kernel. Reads each input
+    sample once and writes both the low and high outputs in the same pass.
+
+    An LR4 low pass is two Butterworth low passes in series, and the high
+    pass is two Butterworth high passes. Since a state variable filter
+    gives us its low and high pass outputs from the same state, the first
+    section of each side can be shared: one SVF splits the input, and one
+    more on each side finishes the job. That's three filter states per
+    channel rather than four, and one pass over memory rather than a copy
+    followed by four.
+
+    In complementary mode, only the low side is filtered. The high output
+    is then derived by subtracting the low output from an allpass copy of
+    the input, where the allpass is the same LR4 phase response that the
+    low and high outputs sum to. That allpass comes for free from the split
+    filter's band pass state, so the high side needs no filter of its own:
+    two filter states per channel instead of three, about half the four
+    biquads per channel we started with. Since LP^2 + HP^2 = AP, the
+    result is the same LR4 high pass, and the two outputs still sum to
+    exactly that allpass.
+
+    Phase compensation: in a serial chain of crossovers, each one splits
+    the high output of the one before it, so the lower bands never see the
+    phase rotation of the later crossovers and the bands don't sum flat.
+    To fix that, the low output can be passed through the allpass response
+    of every later crossover, in the same per-sample loop as the split
+    itself. The whole chain then sums to the product of every crossover's
+    allpass, which is magnitude flat.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "StateVariableFilter.h"
+
+template <typename FloatType>
+class LinkwitzRileyCrossover
+{
+public:
+    enum class Mode
+    {
+        filtered,
+        complementary
+    };
+
+    void setMode(Mode mode) noexcept
+    {
+        // The high pass filter isn't run in complementary mode, so its state
+        // is stale by the time we switch back. Clearing it limits the damage
+        // to a short transient on the high output.
+        if (mode != mode_ && mode == Mode::filtered)
+            high_pass_filter_.reset();
+        mode_ = mode;
+    }
+    Mode getMode() const noexcept { return mode_; }
+
+    void setCutoff(double sample_rate_in_hz, double cutoff_in_hz) noexcept
+    {
+        split_filter_.setCutoff(sample_rate_in_hz, cutoff_in_hz);
+        low_pass_filter_.setCutoff(sample_rate_in_hz, cutoff_in_hz);
+        high_pass_filter_.setCutoff(sample_rate_in_hz, cutoff_in_hz);
+    }
+
+    // Adds an allpass section to the low output for each later crossover in
+    // the chain. Allocates, so call it before prepare() and never on the
+    // audio thread.
+    void setNumPhaseCompensationStages(int num_stages)
+    {
+        phase_compensation_filters_.resize((size_t) num_stages);
+    }
+
+    void setPhaseCompensationCutoff(
+        int stage,
+        double sample_rate_in_hz,
+        double cutoff_in_hz) noexcept
+    {
+        phase_compensation_filters_[(size_t) stage].setCutoff(
+            sample_rate_in_hz,
+            cutoff_in_hz);
+    }
+
+    void prepare(int num_channels)
+    {
+        split_filter_.prepare(num_channels);
+        low_pass_filter_.prepare(num_channels);
+        high_pass_filter_.prepare(num_channels);
+        for (auto& filter : phase_compensation_filters_)
+            filter.prepare(num_channels);
+    }
+
+    void reset() noexcept
+    {
+        split_filter_.reset();
+        low_pass_filter_.reset();
+        high_pass_filter_.reset();
+        for (auto& filter : phase_compensation_filters_)
+            filter.reset();
+    }
+
+    // Splits num_samples of one channel of input into low and high outputs.
+    // The input may be the same memory as either output, since each sample
+    // is read before anything is written back.
+    void process(
+        int channel,
+        const FloatType* input,
+        FloatType* low_output,
+        FloatType* high_output,
+        int num_samples) noexcept
+    {
+        if (mode_ == Mode::complementary)
+        {
+            processComplementary(
+                channel,
+                input,
+                low_output,
+                high_output,
+                num_samples);
+            return;
+        }
+
+        FloatType low, band, high;
+        FloatType low_low, low_band, low_high;
+        FloatType high_low, high_band, high_high;
+
+        for (auto n = 0; n < num_samples; n++)
+        {
+            split_filter_.processSample(channel, input[n], low, band, high);
+            low_pass_filter_.processSample(
+                channel,
+                low,
+                low_low,
+                low_band,
+                low_high);
+            high_pass_filter_.processSample(
+                channel,
+                high,
+                high_low,
+                high_band,
+                high_high);
+
+            low_output[n] = applyPhaseCompensation(channel, low_low);
+            high_output[n] = high_high;
+        }
+    }
+
+private:
+    void processComplementary(
+        int channel,
+        const FloatType* input,
+        FloatType* low_output,
+        FloatType* high_output,
+        int num_samples) noexcept
+    {
+        FloatType low, band, high;
+        FloatType low_low, low_band, low_high;
+        auto two_k = (FloatType) 2 * split_filter_.getDamping();
+
+        for (auto n = 0; n < num_samples; n++)
+        {
+            auto x = input[n];
+            split_filter_.processSample(channel, x, low, band, high);
+            low_pass_filter_.processSample(
+                channel,
+                low,
+                low_low,
+                low_band,
+                low_high);
+
+            // The high side is derived from the uncompensated low output,
+            // so that the two still sum to this crossover's own allpass.
+            high_output[n] = x - two_k * band - low_low;
+            low_output[n] = applyPhaseCompensation(channel, low_low);
+        }
+    }
+
+    FloatType applyPhaseCompensation(int channel, FloatType sample) noexcept
+    {
+        FloatType low, band, high;
+        for (auto& filter : phase_compensation_filters_)
+        {
+            filter.processSample(channel, sample, low, band, high);
+            sample = sample - (FloatType) 2 * filter.getDamping() * band;
+        }
+        return sample;
+    }
+
+    Mode mode_ = Mode::filtered;
+
+    StateVariableFilter<FloatType> split_filter_;
+    StateVariableFilter<FloatType> low_pass_filter_;
+    StateVariableFilter<FloatType> high_pass_filter_;
+    std::vector<StateVariableFilter<FloatType>> phase_compensation_filters_;
+};
@@ -0,0 +1,63 @@
+/*
+  ==============================================================================
+
+    MultibandEngine.h
+    Created: 19 Oct 2026 2:02:40pm
+    Author:  Ben Hayes
+    Description:
+
+    The part of the plugin that does the multiband processing itself, behind
+    one interface so that the plugin can switch engines while it plays (see
+    EngineSwapper).
+
+    An engine owns all of its DSP state, but none of the parameters: it
+    reads its settings from the plugin's CompressorProcessors and
+    CrossoverFilterProcessors, which outlive every engine. That is what lets
+    a new engine be built and prepared on a background thread while the
+    old one carries on playing.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PerformanceMonitor.h"
+
+class MultibandEngine
+{
+public:
+    virtual ~MultibandEngine() = default;
+
+    // Allocates everything the engine will need, for stereo buffers of up
+    // to max_block_size samples (larger ones are fine too, they're just
+    // split up) in the given precision. Never called on the audio thread.
+    virtual void prepare(
+        double sample_rate_in_hz,
+        int max_block_size,
+        bool use_double_precision) = 0;
+
+    // Clears all filter and envelope state. Safe on the audio thread.
+    virtual void reset() = 0;
+
+    // Processes a mono or stereo buffer in place
+    virtual void process(AudioBuffer<float>& buffer) = 0;
+    virtual void process(AudioBuffer<double>& buffer) = 0;
+
+    virtual int getLatencySamples() const = 0;
+
+   #if MBC_ENABLE_INSTRUMENTATION
+    // Where an engine's stages record their timings. The plugin adds the
+    // stages to its monitor once, and every engine it builds shares them.
+    struct PerformanceStages
+    {
+        PerformanceMonitor* monitor = nullptr;
+        Array<int> crossovers;
+        int compressors = -1;
+        int summing = -1;
+        int spectral = -1;
+    };
+
+    virtual void setPerformanceStages(const PerformanceStages& stages) = 0;
+   #endif
+};
@@ -0,0 +1,324 @@
+/*
+  ==============================================================================
+
+    OfflineRenderer.cpp
+    Created: 19 Oct 2026 1:34:30pm
+    Author:  Ben Hayes
+
+  ==============================================================================
+*/
+
+#include "OfflineRenderer.h"
+
+class OfflineRenderer::BlockQueue
+{
+// A single producer, single consumer queue of block indices. Every queue is
+// big enough to hold every block at once, so pushing never fails, and
+// popping never blocks: callers that find it empty can wait() for a moment.
+public:
+    BlockQueue(int capacity)
+        : fifo_ (capacity + 1),
+          indices_ ((size_t) capacity + 1)
+    {
+    }
+
+    void push(int index) noexcept
+    {
+        int start_1, size_1, start_2, size_2;
+        fifo_.prepareToWrite(1, start_1, size_1, start_2, size_2);
+        jassert(size_1 + size_2 == 1);
+        indices_[(size_t) (size_1 > 0 ? start_1 : start_2)] = index;
+        fifo_.finishedWrite(size_1 + size_2);
+        ready_.signal();
+    }
+
+    bool pop(int& index) noexcept
+    {
+        int start_1, size_1, start_2, size_2;
+        fifo_.prepareToRead(1, start_1, size_1, start_2, size_2);
+        if (size_1 + size_2 == 0)
+            return false;
+        index = indices_[(size_t) (size_1 > 0 ? start_1 : start_2)];
+        fifo_.finishedRead(size_1 + size_2);
+        return true;
+    }
+
+    void wait() { ready_.wait(1); }
+
+private:
+    AbstractFifo fifo_;
+    std::vector<int> indices_;
+    WaitableEvent ready_;
+};
+
+class OfflineRenderer::StageThread : public Thread
+{
+public:
+    StageThread(const String& name, std::function<void()> work)
+        : Thread(name),
+          work_ (std::move(work))
+    {
+    }
+
+    ~StageThread()
+    {
+        stopThread(10000);
+    }
+
+    void run() override { work_(); }
+
+private:
+    std::function<void()> work_;
+};
+
+//==============================================================================
+OfflineRenderer::OfflineRenderer(AudioProcessor& processor, Options options)
+    : processor_ (processor),
+      options_ (options)
+{
+    format_manager_.registerBasicFormats();
+}
+
+OfflineRenderer::OfflineRenderer(AudioProcessor& processor)
+    : OfflineRenderer(processor, Options())
+{
+}
+
+OfflineRenderer::~OfflineRenderer()
+{
+}
+
+Result OfflineRenderer::render(const File& input_file, const File& output_file)
+{
+    // We memory-map the input if its format supports it, and fall back to
+    // streaming it from disk otherwise:
+    std::unique_ptr<AudioFormatReader> reader;
+    if (auto input_format = format_manager_.findFormatForFileExtension(
+            input_file.getFileExtension()))
+    {
+        std::unique_ptr<MemoryMappedAudioFormatReader> mapped_reader (
+            input_format->createMemoryMappedReader(input_file));
+        if (mapped_reader != nullptr && mapped_reader->mapEntireFile())
+            reader = std::move(mapped_reader);
+    }
+    if (reader == nullptr)
+        reader.reset(format_manager_.createReaderFor(input_file));
+    if (reader == nullptr)
+        return Result::fail("Couldn't read " + input_file.getFullPathName());
+
+    auto output_format = format_manager_.findFormatForFileExtension(
+        output_file.getFileExtension());
+    if (output_format == nullptr)
+        return Result::fail("Unknown format for " + output_file.getFullPathName());
+
+    auto sample_rate = reader->sampleRate;
+    auto num_channels = jmax(
+        processor_.getTotalNumInputChannels(),
+        processor_.getTotalNumOutputChannels());
+
+    output_file.deleteFile();
+    std::unique_ptr<FileOutputStream> stream (output_file.createOutputStream());
+    if (stream == nullptr)
+        return Result::fail("Couldn't write " + output_file.getFullPathName());
+
+    std::unique_ptr<AudioFormatWriter> writer (output_format->createWriterFor(
+        stream.get(),
+        sample_rate,
+        (unsigned int) processor_.getTotalNumOutputChannels(),
+        options_.output_bits_per_sample,
+        {},
+        0));
+    if (writer == nullptr)
+        return Result::fail("Couldn't write " + output_file.getFullPathName());
+    // The writer owns the stream from here on
+    stream.release();
+
+    processor_.setNonRealtime(true);
+    processor_.setRateAndBufferSizeDetails(sample_rate, options_.block_size);
+    processor_.prepareToPlay(sample_rate, options_.block_size);
+
+    // We run the processor on for long enough to flush out its latency and
+    // its tail, and drop the latency from the start of the output, so the
+    // output lines up with the input.
+    auto latency = (int64) processor_.getLatencySamples();
+    auto tail = (int64) std::ceil(
+        jmin(processor_.getTailLengthSeconds(), 10.0) * sample_rate);
+    auto output_length = reader->lengthInSamples + tail;
+    auto total_samples = output_length + latency;
+
+    allocateBlocks(num_channels);
+    failed_ = false;
+
+    {
+        StageThread reader_thread (
+            "Offline reader",
+            [this, &reader, total_samples] { runReader(*reader, total_samples); });
+        StageThread writer_thread (
+            "Offline writer",
+            [this, &writer, latency, output_length]
+            {
+                runWriter(*writer, latency, output_length);
+            });
+        reader_thread.startThread();
+        writer_thread.startThread();
+
+        // The DSP stage runs on this thread
+        if (! runProcessor(total_samples))
+            failed_ = true;
+
+        writer_thread.waitForThreadToExit(-1);
+    }
+
+    // Destroying the writer flushes the file to disk
+    writer.reset();
+    processor_.releaseResources();
+
+    if (failed_)
+        return Result::fail("Failed while rendering " + input_file.getFullPathName());
+    return Result::ok();
+}
+
+Result OfflineRenderer::renderAll(
+    const Array<File>& input_files,
+    const File& output_directory)
+{
+    for (auto& input_file : input_files)
+    {
+        auto result = render(
+            input_file,
+            output_directory.getChildFile(input_file.getFileName()));
+        if (result.failed())
+            return result;
+    }
+    return Result::ok();
+}
+
+void OfflineRenderer::allocateBlocks(int num_channels)
+{
+    // Every block we'll need for the whole render is allocated up front, and
+    // they all start off in the free queue waiting for the reader.
+    blocks_.resize((size_t) options_.num_blocks);
+    for (auto& block : blocks_)
+    {
+        block.buffer.setSize(num_channels, options_.block_size);
+        block.num_samples = 0;
+    }
+
+    free_blocks_ = std::make_unique<BlockQueue>(options_.num_blocks);
+    read_blocks_ = std::make_unique<BlockQueue>(options_.num_blocks);
+    processed_blocks_ = std::make_unique<BlockQueue>(options_.num_blocks);
+
+    for (auto index = 0; index < options_.num_blocks; index++)
+        free_blocks_->push(index);
+}
+
+void OfflineRenderer::runReader(AudioFormatReader& reader, int64 total_samples)
+{
+    int64 position = 0;
+    while (position < total_samples
+           && ! failed_
+           && ! Thread::currentThreadShouldExit())
+    {
+        int index;
+        if (! free_blocks_->pop(index))
+        {
+            free_blocks_->wait();
+            continue;
+        }
+
+        // We only ask the reader for what's left of the file, since some
+        // readers (memory mapped ones in particular) assert if we read past
+        // the end. The rest of the block is silence, which is what we want
+        // for flushing out the latency and tail.
+        auto& block = blocks_[(size_t) index];
+        block.num_samples = (int) jmin(
+            (int64) options_.block_size,
+            total_samples - position);
+        auto num_samples_to_read = (int) jlimit(
+            (int64) 0,
+            (int64) block.num_samples,
+            reader.lengthInSamples - position);
+        if (num_samples_to_read > 0)
+            reader.read(&block.buffer, 0, num_samples_to_read, position, true, true);
+        block.buffer.clear(
+            num_samples_to_read,
+            block.num_samples - num_samples_to_read);
+
+        position += block.num_samples;
+        read_blocks_->push(index);
+    }
+}
+
+bool OfflineRenderer::runProcessor(int64 total_samples)
+{
+    MidiBuffer midi_messages;
+    int64 position = 0;
+    while (position < total_samples)
+    {
+        if (failed_)
+            return false;
+
+        int index;
+        if (! read_blocks_->pop(index))
+        {
+            read_blocks_->wait();
+            continue;
+        }
+
+        // The processor sees a buffer exactly as long as the block, which
+        // only differs from the block size for the last one.
+        auto& block = blocks_[(size_t) index];
+        AudioBuffer<float> block_view {
+            block.buffer.getArrayOfWritePointers(),
+            block.buffer.getNumChannels(),
+            block.num_samples};
+
+        {
+            const ScopedLock lock (processor_.getCallbackLock());
+            midi_messages.clear();
+            processor_.processBlock(block_view, midi_messages);
+        }
+
+        position += block.num_samples;
+        processed_blocks_->push(index);
+    }
+    return true;
+}
+
+void OfflineRenderer::runWriter(
+    AudioFormatWriter& writer,
+    int64 samples_to_skip,
+    int64 samples_to_write)
+{
+    int64 position = 0;
+    auto end_position = samples_to_skip + samples_to_write;
+    while (position < end_position
+           && ! failed_
+           && ! Thread::currentThreadShouldExit())
+    {
+        int index;
+        if (! processed_blocks_->pop(index))
+        {
+            processed_blocks_->wait();
+            continue;
+        }
+
+        // Skip whatever part of this block falls in the latency at the
+        // start, and anything past the end of the tail:
+        auto& block = blocks_[(size_t) index];
+        auto start = (int) jlimit(
+            (int64) 0,
+            (int64) block.num_samples,
+            samples_to_skip - position);
+        auto count = (int) jmin(
+            (int64) (block.num_samples - start),
+            end_position - position - start);
+
+        if (count > 0
+            && ! writer.writeFromAudioSampleBuffer(block.buffer, start, count))
+            failed_ = true;
+
+        position += block.num_samples;
+        free_blocks_->push(index);
+    }
+}
@@ -0,0 +1,81 @@
+/*
+  ==============================================================================
+
+    OfflineRenderer.h
+    Created: 19 Oct 2026 1:34:30pm
+    Author:  Ben Hayes
+    Description:
+
+    Renders audio files through an AudioProcessor (normally our
+    MultibandCompressorAudioProcessor) as fast as the processor allows.
+
+    The work is split into three stages connected by bounded lock-free
+    queues of preallocated blocks:
+
+        reader thread -> DSP (calling thread) -> writer thread
+
+    The reader memory-maps the input where the format allows it (WAV and
+    AIFF) and streams it otherwise, running ahead of the DSP by as many
+    blocks as the queues hold. The writer encodes and writes finished blocks
+    behind it. Blocks go round in a loop, so nothing is allocated once a
+    render has started, and disk I/O only stalls the DSP if the disk can't
+    keep up on average.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+
+class OfflineRenderer
+{
+public:
+    struct Options
+    {
+        int block_size = 4096;
+        int num_blocks = 16;
+        int output_bits_per_sample = 24;
+    };
+
+    OfflineRenderer(AudioProcessor& processor, Options options);
+    OfflineRenderer(AudioProcessor& processor);
+    ~OfflineRenderer();
+
+    // Renders one file. The output format is chosen from the output file's
+    // extension, and any existing output file is replaced.
+    Result render(const File& input_file, const File& output_file);
+
+    // Renders each input into output_directory with the same file name,
+    // one after another, stopping at the first failure.
+    Result renderAll(const Array<File>& input_files, const File& output_directory);
+
+private:
+    class BlockQueue;
+    class StageThread;
+
+    struct Block
+    {
+        AudioBuffer<float> buffer;
+        int num_samples = 0;
+    };
+
+    void allocateBlocks(int num_channels);
+    void runReader(AudioFormatReader& reader, int64 total_samples);
+    void runWriter(AudioFormatWriter& writer, int64 samples_to_skip, int64 samples_to_write);
+    bool runProcessor(int64 total_samples);
+
+    AudioProcessor& processor_;
+    Options options_;
+    AudioFormatManager format_manager_;
+
+    std::vector<Block> blocks_;
+    std::unique_ptr<BlockQueue> free_blocks_;
+    std::unique_ptr<BlockQueue> read_blocks_;
+    std::unique_ptr<BlockQueue> processed_blocks_;
+
+    std::atomic<bool> failed_ {false};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OfflineRenderer)
+};
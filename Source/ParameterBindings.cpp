@@ -0,0 +1,214 @@
+/*
+  ==============================================================================
+
+    ParameterBindings.cpp
+    Created: 19 Oct 2026 2:07:58pm
+    Author:  Ben Hayes
+
+  ==============================================================================
+*/
+
+#include "ParameterBindings.h"
+
+constexpr int ParameterBindings::poll_rate_in_hz;
+
+class ParameterBindings::Binding
+{
+// One control bound to one parameter. We remember the parameter's value
+// as we last saw it, so each poll only updates the control when it has
+// actually moved.
+public:
+    Binding(RangedAudioParameter& parameter)
+        : parameter_ (parameter),
+          last_value_ (parameter.getValue())
+    {
+    }
+
+    virtual ~Binding() = default;
+
+    void poll()
+    {
+        auto value = parameter_.getValue();
+        if (value == last_value_ || isBeingChanged())
+            return;
+
+        last_value_ = value;
+        updateControl(value);
+    }
+
+protected:
+    // Sets the parameter from the control, as one gesture unless the user
+    // is already partway through one (dragging a slider, say)
+    void setParameter(float value, bool is_in_gesture)
+    {
+        if (value == last_value_)
+            return;
+
+        last_value_ = value;
+        if (! is_in_gesture)
+            parameter_.beginChangeGesture();
+        parameter_.setValueNotifyingHost(value);
+        if (! is_in_gesture)
+            parameter_.endChangeGesture();
+    }
+
+    virtual void updateControl(float value) = 0;
+    virtual bool isBeingChanged() const { return false; }
+
+    RangedAudioParameter& parameter_;
+
+private:
+    float last_value_;
+};
+
+class ParameterBindings::SliderBinding : public Binding,
+                                         private Slider::Listener
+{
+public:
+    SliderBinding(
+        Slider& slider,
+        RangedAudioParameter& parameter,
+        double interval)
+        : Binding (parameter),
+          slider_ (slider)
+    {
+        auto& range = parameter.getNormalisableRange();
+        slider_.setRange(
+            range.start,
+            range.end,
+            interval > 0.0 ? interval : range.interval);
+        if (range.skew != 1.0f)
+            slider_.setSkewFactor(range.skew, range.symmetricSkew);
+        slider_.setDoubleClickReturnValue(
+            true,
+            parameter.convertFrom0to1(parameter.getDefaultValue()));
+
+        updateControl(parameter.getValue());
+        slider_.addListener(this);
+    }
+
+    ~SliderBinding()
+    {
+        slider_.removeListener(this);
+    }
+
+private:
+    void updateControl(float value) override
+    {
+        slider_.setValue(parameter_.convertFrom0to1(value), dontSendNotification);
+    }
+
+    // While the user is dragging, they win over any automation
+    bool isBeingChanged() const override { return is_dragging_; }
+
+    void sliderValueChanged(Slider*) override
+    {
+        setParameter(
+            parameter_.convertTo0to1((float) slider_.getValue()),
+            is_dragging_);
+    }
+
+    void sliderDragStarted(Slider*) override
+    {
+        is_dragging_ = true;
+        parameter_.beginChangeGesture();
+    }
+
+    void sliderDragEnded(Slider*) override
+    {
+        is_dragging_ = false;
+        parameter_.endChangeGesture();
+    }
+
+    Slider& slider_;
+    bool is_dragging_ = false;
+};
+
+class ParameterBindings::ButtonBinding : public Binding,
+                                         private Button::Listener
+{
+// Works for both kinds of button parameter: a bool is just a choice
+// between 1 and 0.
+public:
+    ButtonBinding(
+        Button& button,
+        RangedAudioParameter& parameter,
+        float on_value,
+        float off_value)
+        : Binding (parameter),
+          button_ (button),
+          on_value_ (on_value),
+          off_value_ (off_value)
+    {
+        button_.setClickingTogglesState(true);
+        updateControl(parameter.getValue());
+        button_.addListener(this);
+    }
+
+    ~ButtonBinding()
+    {
+        button_.removeListener(this);
+    }
+
+private:
+    void updateControl(float value) override
+    {
+        // Anything closer to on than off counts as on
+        button_.setToggleState(
+            std::abs(value - on_value_) < std::abs(value - off_value_),
+            dontSendNotification);
+    }
+
+    void buttonClicked(Button*) override
+    {
+        setParameter(
+            button_.getToggleState() ? on_value_ : off_value_,
+            false);
+    }
+
+    Button& button_;
+    float on_value_;
+    float off_value_;
+};
+
+ParameterBindings::ParameterBindings()
+{
+    startTimerHz(poll_rate_in_hz);
+}
+
+ParameterBindings::~ParameterBindings()
+{
+    stopTimer();
+}
+
+void ParameterBindings::bind(
+    Slider& slider,
+    RangedAudioParameter& parameter,
+    double interval)
+{
+    bindings_.add(new SliderBinding(slider, parameter, interval));
+}
+
+void ParameterBindings::bind(Button& button, AudioParameterBool& parameter)
+{
+    bindings_.add(new ButtonBinding(button, parameter, 1.0f, 0.0f));
+}
+
+void ParameterBindings::bind(
+    Button& button,
+    AudioParameterChoice& parameter,
+    int on_index,
+    int off_index)
+{
+    bindings_.add(new ButtonBinding(
+        button,
+        parameter,
+        parameter.convertTo0to1((float) on_index),
+        parameter.convertTo0to1((float) off_index)));
+}
+
+void ParameterBindings::timerCallback()
+{
+    for (auto binding : bindings_)
+        binding->poll();
+}
@@ -0,0 +1,64 @@
+/*
+  ==============================================================================
+
+    ParameterBindings.h
+    Created: 19 Oct 2026 2:07:58pm
+    Author:  Ben Hayes
+    Description:
+
+    Binds the editor's sliders and buttons to our parameters both ways.
+
+    A control takes its range, default and current value from its
+    parameter, and when the user moves it, the host is told through
+    setValueNotifyingHost, wrapped in a change gesture so that it records
+    the move as one piece of automation.
+
+    Going the other way, rather than listening to every parameter (which
+    calls back on the audio thread for every automated change), one timer
+    polls every bound parameter a few dozen times a second and only
+    touches the controls whose parameter has moved. However dense the
+    host's automation, the message thread does the same small amount of
+    work per frame.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class ParameterBindings : private Timer
+{
+public:
+    // Plenty for a control to follow automation smoothly
+    static constexpr int poll_rate_in_hz = 30;
+
+    ParameterBindings();
+    ~ParameterBindings();
+
+    // The slider takes the parameter's range and default. If interval is
+    // given, the slider steps by it, otherwise by the parameter's own
+    // interval. Any skew already set on the slider is kept unless the
+    // parameter has one of its own.
+    void bind(Slider& slider, RangedAudioParameter& parameter, double interval = 0.0);
+    // A toggle button that's on when the parameter is
+    void bind(Button& button, AudioParameterBool& parameter);
+    // A toggle button that picks between two of a choice parameter's
+    // choices
+    void bind(
+        Button& button,
+        AudioParameterChoice& parameter,
+        int on_index,
+        int off_index);
+
+private:
+    class Binding;
+    class SliderBinding;
+    class ButtonBinding;
+
+    void timerCallback() override;
+
+    OwnedArray<Binding> bindings_;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ParameterBindings)
+};
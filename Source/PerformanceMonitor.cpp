@@ -0,0 +1,237 @@
+/*
+  ==============================================================================
+
+    PerformanceMonitor.cpp
+    Created: 19 Oct 2026 1:27:08pm
+    Author:  Ben Hayes
+
+  ==============================================================================
+*/
+
+#include "PerformanceMonitor.h"
+
+#if MBC_ENABLE_INSTRUMENTATION
+
+StageHistogram::StageHistogram()
+{
+    clear();
+}
+
+void StageHistogram::record(uint32 value) noexcept
+{
+    // Only the audio thread ever writes, so a plain load/store pair is enough
+    // for the bins. The maximum still needs to be monotonic for readers.
+    auto& bin = bins_[binForValue(value)];
+    bin.store(bin.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    count_.store(
+        count_.load(std::memory_order_relaxed) + 1,
+        std::memory_order_relaxed);
+
+    if (value > max_.load(std::memory_order_relaxed))
+        max_.store(value, std::memory_order_relaxed);
+}
+
+void StageHistogram::clear() noexcept
+{
+    for (auto& bin : bins_)
+        bin.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+    count_.store(0, std::memory_order_relaxed);
+}
+
+uint32 StageHistogram::getPercentile(float percentile) const noexcept
+{
+    // Walk up the bins until we have seen the requested proportion of all the
+    // values we have recorded, and return the centre of that bin:
+    auto count = getCount();
+    if (count == 0)
+        return 0;
+
+    auto target = (uint32) std::ceil(percentile * 0.01f * (float) count);
+    target = jlimit((uint32) 1, count, target);
+
+    uint32 seen = 0;
+    for (auto bin = 0; bin < num_bins; bin++)
+    {
+        seen += bins_[bin].load(std::memory_order_relaxed);
+        if (seen >= target)
+            return jmin(valueForBin(bin), getMax());
+    }
+    return getMax();
+}
+
+int StageHistogram::binForValue(uint32 value) noexcept
+{
+    // The first four values get a bin each. After that, each octave is split
+    // into four bins using the two bits just below the highest set bit.
+    if (value < 4)
+        return (int) value;
+
+    auto highest_bit = 2;
+    while ((value >> (highest_bit + 1)) != 0)
+        highest_bit++;
+
+    auto sub_bin = (int) ((value >> (highest_bit - 2)) & 3);
+    return jmin(num_bins - 1, (highest_bit - 1) * 4 + sub_bin);
+}
+
+uint32 StageHistogram::valueForBin(int bin) noexcept
+{
+    if (bin < 4)
+        return (uint32) bin;
+
+    auto highest_bit = bin / 4 + 1;
+    auto sub_bin = (uint32) (bin % 4);
+    auto width = (uint32) 1 << (highest_bit - 2);
+    return (4 + sub_bin) * width + width / 2;
+}
+
+//==============================================================================
+PerformanceMonitor::PerformanceMonitor()
+    : nanoseconds_per_tick_ (
+          1.0e9 / (double) Time::getHighResolutionTicksPerSecond())
+{
+    for (auto& time : startup_ns_)
+        time.store(0, std::memory_order_relaxed);
+}
+
+int PerformanceMonitor::addStage(const String& name)
+{
+    auto stage = new Stage();
+    stage->name = name;
+    stages_.add(stage);
+    return stages_.size() - 1;
+}
+
+void PerformanceMonitor::prepare(double sampleRate)
+{
+    sample_rate_in_hz_ = sampleRate;
+    clear();
+}
+
+void PerformanceMonitor::clear()
+{
+    for (auto stage : stages_)
+        stage->histogram.clear();
+    total_.clear();
+    remainder_.clear();
+    budget_in_permille_.clear();
+    editor_frame_.clear();
+}
+
+void PerformanceMonitor::setStartupTime(StartupPhase phase, int64 ticks) noexcept
+{
+    startup_ns_[(size_t) phase].store(
+        ticksToNanoseconds(ticks),
+        std::memory_order_relaxed);
+}
+
+uint32 PerformanceMonitor::getStartupTime(StartupPhase phase) const noexcept
+{
+    return startup_ns_[(size_t) phase].load(std::memory_order_relaxed);
+}
+
+void PerformanceMonitor::beginBlock() noexcept
+{
+    for (auto stage : stages_)
+        stage->block_ticks = 0;
+}
+
+void PerformanceMonitor::addStageTicks(int stage, int64 ticks) noexcept
+{
+    // A stage may run more than once per block, so we accumulate here and
+    // only record into the histogram at the end of the block.
+    stages_.getUnchecked(stage)->block_ticks += ticks;
+}
+
+void PerformanceMonitor::endBlock(int64 total_ticks, int num_samples) noexcept
+{
+    auto accounted_ticks = (int64) 0;
+    for (auto stage : stages_)
+    {
+        stage->histogram.record(ticksToNanoseconds(stage->block_ticks));
+        accounted_ticks += stage->block_ticks;
+    }
+
+    // Whatever we didn't time explicitly was spent routing and summing
+    // buffers between the stages:
+    remainder_.record(ticksToNanoseconds(total_ticks - accounted_ticks));
+    total_.record(ticksToNanoseconds(total_ticks));
+
+    // And express the whole block as a proportion of the time we had to
+    // process it in:
+    if (num_samples > 0)
+    {
+        auto budget_in_ns = num_samples * 1.0e9 / sample_rate_in_hz_;
+        budget_in_permille_.record((uint32) jlimit(
+            0.0,
+            (double) std::numeric_limits<uint32>::max(),
+            1000.0 * total_ticks * nanoseconds_per_tick_ / budget_in_ns));
+    }
+}
+
+void PerformanceMonitor::recordEditorFrame(int64 ticks) noexcept
+{
+    // Only the message thread writes this one, so it gets a histogram of
+    // its own rather than being a stage of the audio thread's blocks.
+    editor_frame_.record(ticksToNanoseconds(ticks));
+}
+
+uint32 PerformanceMonitor::ticksToNanoseconds(int64 ticks) const noexcept
+{
+    return (uint32) jlimit(
+        0.0,
+        (double) std::numeric_limits<uint32>::max(),
+        ticks * nanoseconds_per_tick_);
+}
+
+static var histogramToVar(const String& name, const StageHistogram& histogram)
+{
+    DynamicObject::Ptr object (new DynamicObject());
+    object->setProperty("name", name);
+    object->setProperty("count", (int) histogram.getCount());
+    object->setProperty("p50", (int) histogram.getPercentile(50.0f));
+    object->setProperty("p99", (int) histogram.getPercentile(99.0f));
+    object->setProperty("max", (int) histogram.getMax());
+    return var(object.get());
+}
+
+var PerformanceMonitor::toVar() const
+{
+    // Stage timings are in nanoseconds, budget usage is in per-mille of the
+    // realtime budget for each block.
+    Array<var> stages;
+    for (auto stage : stages_)
+        stages.add(histogramToVar(stage->name, stage->histogram));
+    stages.add(histogramToVar("Routing & overhead", remainder_));
+
+    DynamicObject::Ptr startup (new DynamicObject());
+    startup->setProperty("construct", (int) getStartupTime(construction));
+    startup->setProperty("prepare", (int) getStartupTime(preparation));
+    startup->setProperty("editor_open", (int) getStartupTime(editor_opening));
+
+    DynamicObject::Ptr object (new DynamicObject());
+    object->setProperty("sample_rate", sample_rate_in_hz_);
+    object->setProperty("startup_ns", var(startup.get()));
+    object->setProperty("stages_ns", stages);
+    object->setProperty("total_ns", histogramToVar("Total", total_));
+    object->setProperty(
+        "budget_permille",
+        histogramToVar("Budget", budget_in_permille_));
+    object->setProperty(
+        "editor_frame_ns",
+        histogramToVar("Editor frame", editor_frame_));
+    return var(object.get());
+}
+
+String PerformanceMonitor::toJSON() const
+{
+    return JSON::toString(toVar());
+}
+
+bool PerformanceMonitor::dumpToFile(const File& file) const
+{
+    return file.replaceWithText(toJSON());
+}
+
+#endif
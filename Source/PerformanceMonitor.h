@@ -0,0 +1,161 @@
+/*
+  ==============================================================================
+
+    PerformanceMonitor.h
+    Created: 19 Oct 2026 1:27:08pm
+    Author:  Ben Hayes
+    Description:
+
+    Optional hot-path instrumentation. Each stage of the multiband process
+    (every crossover, the compressor bank, the summing, and whatever routing
+    is left over) records how long it took per block into a lock-free
+    histogram, from which we can read percentiles and how much of the
+    realtime budget a block used.
+
+    Set MBC_ENABLE_INSTRUMENTATION=1 in the project's preprocessor
+    definitions to build it in. When it is 0 (the default) none of these
+    classes are compiled, and the timing macro expands to nothing.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+
+#ifndef MBC_ENABLE_INSTRUMENTATION
+ #define MBC_ENABLE_INSTRUMENTATION 0
+#endif
+
+#if MBC_ENABLE_INSTRUMENTATION
+
+class StageHistogram
+{
+// A fixed size histogram with four logarithmically spaced bins per octave.
+// Only the audio thread writes to it, but any thread can read it, so all of
+// its state is held in relaxed atomics.
+public:
+    StageHistogram();
+
+    void record(uint32 value) noexcept;
+    void clear() noexcept;
+
+    uint32 getPercentile(float percentile) const noexcept;
+    uint32 getMax() const noexcept { return max_.load(std::memory_order_relaxed); }
+    uint32 getCount() const noexcept { return count_.load(std::memory_order_relaxed); }
+
+    static constexpr int num_bins = 128;
+
+private:
+    static int binForValue(uint32 value) noexcept;
+    static uint32 valueForBin(int bin) noexcept;
+
+    std::array<std::atomic<uint32>, num_bins> bins_;
+    std::atomic<uint32> max_;
+    std::atomic<uint32> count_;
+};
+
+class PerformanceMonitor
+{
+public:
+    PerformanceMonitor();
+
+    // Stages must all be added before processing starts. Returns the index
+    // that should be passed to addStageTicks().
+    int addStage(const String& name);
+    void prepare(double sampleRate);
+    void clear();
+
+    // One-off startup costs, recorded from the message thread
+    enum StartupPhase
+    {
+        construction = 0,
+        preparation,
+        editor_opening,
+        num_startup_phases
+    };
+    void setStartupTime(StartupPhase phase, int64 ticks) noexcept;
+    uint32 getStartupTime(StartupPhase phase) const noexcept;
+
+    // Called from the audio thread only:
+    void beginBlock() noexcept;
+    void addStageTicks(int stage, int64 ticks) noexcept;
+    void endBlock(int64 total_ticks, int num_samples) noexcept;
+
+    // Called from the message thread only: how long the editor spent
+    // working out and painting one frame of its displays
+    void recordEditorFrame(int64 ticks) noexcept;
+
+    // Called from any other thread:
+    int getNumStages() const { return stages_.size(); }
+    const String& getStageName(int stage) const { return stages_[stage]->name; }
+    const StageHistogram& getStageHistogram(int stage) const
+        { return stages_[stage]->histogram; }
+    const StageHistogram& getRemainderHistogram() const { return remainder_; }
+    const StageHistogram& getTotalHistogram() const { return total_; }
+    const StageHistogram& getBudgetHistogram() const { return budget_in_permille_; }
+    const StageHistogram& getEditorFrameHistogram() const { return editor_frame_; }
+
+    var toVar() const;
+    String toJSON() const;
+    bool dumpToFile(const File& file) const;
+
+private:
+    struct Stage
+    {
+        String name;
+        StageHistogram histogram;
+        int64 block_ticks = 0;
+    };
+
+    uint32 ticksToNanoseconds(int64 ticks) const noexcept;
+
+    OwnedArray<Stage> stages_;
+    StageHistogram total_;
+    StageHistogram remainder_;
+    StageHistogram budget_in_permille_;
+    StageHistogram editor_frame_;
+    std::array<std::atomic<uint32>, num_startup_phases> startup_ns_;
+
+    double nanoseconds_per_tick_;
+    double sample_rate_in_hz_ = 44100.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PerformanceMonitor)
+};
+
+class ScopedStageTimer
+{
+// Adds the time between its construction and destruction to a stage of a
+// PerformanceMonitor. Does nothing if the monitor pointer is null.
+public:
+    ScopedStageTimer(PerformanceMonitor* monitor, int stage) noexcept
+        : monitor_ (monitor),
+          stage_ (stage),
+          start_ticks_ (Time::getHighResolutionTicks())
+    {
+    }
+
+    ~ScopedStageTimer()
+    {
+        if (monitor_ != nullptr)
+            monitor_->addStageTicks(
+                stage_,
+                Time::getHighResolutionTicks() - start_ticks_);
+    }
+
+private:
+    PerformanceMonitor* monitor_;
+    int stage_;
+    int64 start_ticks_;
+};
+
+#define MBC_TIME_STAGE(monitor, stage) \
+    ScopedStageTimer JUCE_JOIN_MACRO (stage_timer_, __LINE__) (monitor, stage)
+
+#else
+
+#define MBC_TIME_STAGE(monitor, stage)
+
+#endif
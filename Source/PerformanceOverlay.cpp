@@ -0,0 +1,105 @@
+/*
+  ==============================================================================
+
+    PerformanceOverlay.cpp
+    Created: 19 Oct 2026 1:27:08pm
+    Author:  Ben Hayes
+
+  ==============================================================================
+*/
+
+#include "PerformanceOverlay.h"
+
+#if MBC_ENABLE_INSTRUMENTATION
+
+static const int line_height = 14;
+
+PerformanceOverlay::PerformanceOverlay(PerformanceMonitor& monitor)
+    : monitor_ (monitor)
+{
+    setInterceptsMouseClicks(false, false);
+
+    // The numbers only need to be readable, so a couple of updates a second
+    // is plenty:
+    startTimerHz(2);
+}
+
+PerformanceOverlay::~PerformanceOverlay()
+{
+    stopTimer();
+}
+
+int PerformanceOverlay::getIdealHeight(const PerformanceMonitor& monitor)
+{
+    // One line per stage, plus the overhead, total, budget, editor frame
+    // and startup lines:
+    return (monitor.getNumStages() + 5) * line_height + 10;
+}
+
+static String formatHistogram(
+    const String& name,
+    const StageHistogram& histogram,
+    double scale,
+    const String& units)
+{
+    return name.paddedRight(' ', 22)
+        + "p50 " + String(histogram.getPercentile(50.0f) * scale, 1) + units
+        + "   p99 " + String(histogram.getPercentile(99.0f) * scale, 1) + units
+        + "   max " + String(histogram.getMax() * scale, 1) + units;
+}
+
+void PerformanceOverlay::paint(Graphics& g)
+{
+    g.fillAll(Colours::black.withAlpha(0.7f));
+    g.setColour(Colours::white);
+    g.setFont(Font(Font::getDefaultMonospacedFontName(), 12.0f, Font::plain));
+
+    // Stage timings are stored in nanoseconds but microseconds are easier to
+    // read at a glance:
+    StringArray lines;
+    for (auto stage = 0; stage < monitor_.getNumStages(); stage++)
+        lines.add(formatHistogram(
+            monitor_.getStageName(stage),
+            monitor_.getStageHistogram(stage),
+            0.001,
+            " us"));
+    lines.add(formatHistogram(
+        "Routing & overhead",
+        monitor_.getRemainderHistogram(),
+        0.001,
+        " us"));
+    lines.add(formatHistogram(
+        "Total",
+        monitor_.getTotalHistogram(),
+        0.001,
+        " us"));
+    lines.add(formatHistogram(
+        "Realtime budget",
+        monitor_.getBudgetHistogram(),
+        0.1,
+        " %"));
+    lines.add(formatHistogram(
+        "Editor frame",
+        monitor_.getEditorFrameHistogram(),
+        0.001,
+        " us"));
+    lines.add("Startup".paddedRight(' ', 22)
+        + "construct " + String(monitor_.getStartupTime(PerformanceMonitor::construction) * 1.0e-6, 2) + " ms"
+        + "   prepare " + String(monitor_.getStartupTime(PerformanceMonitor::preparation) * 1.0e-6, 2) + " ms"
+        + "   editor " + String(monitor_.getStartupTime(PerformanceMonitor::editor_opening) * 1.0e-6, 2) + " ms");
+
+    auto bounds = getLocalBounds().reduced(5);
+    for (auto& line : lines)
+        g.drawText(
+            line,
+            bounds.removeFromTop(line_height),
+            Justification::centredLeft,
+            false);
+}
+
+void PerformanceOverlay::timerCallback()
+{
+    repaint();
+}
+
+#endif
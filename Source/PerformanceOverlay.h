@@ -0,0 +1,44 @@
+/*
+  ==============================================================================
+
+    PerformanceOverlay.h
+    Created: 19 Oct 2026 1:27:08pm
+    Author:  Ben Hayes
+    Description:
+
+    A small text overlay for the editor that shows the per-stage timings
+    collected by a PerformanceMonitor. Only built when
+    MBC_ENABLE_INSTRUMENTATION is set.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PerformanceMonitor.h"
+
+#if MBC_ENABLE_INSTRUMENTATION
+
+class PerformanceOverlay : public Component,
+                           private Timer
+{
+public:
+    PerformanceOverlay(PerformanceMonitor& monitor);
+    ~PerformanceOverlay();
+
+    void paint(Graphics& g) override;
+
+    // The height needed to show every stage of a monitor plus the summary
+    // lines, so an editor can size itself before it makes an overlay
+    static int getIdealHeight(const PerformanceMonitor& monitor);
+
+private:
+    void timerCallback() override;
+
+    PerformanceMonitor& monitor_;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PerformanceOverlay)
+};
+
+#endif
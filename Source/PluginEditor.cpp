@@ -1,11 +1,50 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 
+static const int analyser_height = 160;
+
 //==============================================================================
 MultibandCompressorAudioProcessorEditor::MultibandCompressorAudioProcessorEditor (MultibandCompressorAudioProcessor& p)
     : AudioProcessorEditor (&p), processor (p)
 {
-    auto num_compressors = processor.compressor_nodes_.size();
+   #if MBC_ENABLE_INSTRUMENTATION
+    auto editor_start_ticks = Time::getHighResolutionTicks();
+   #endif
+
+    // All we do here is size ourselves. Our controls are built the first
+    // time we're shown (see createControlsIfShowing).
+
+    // We fill our whole area, so the host never needs to paint behind us
+    setOpaque(true);
+
+    // Set our editor width based on the number of compressors we have:
+    auto width = processor.compressors_.size() * 220 + 10;
+    auto height = 230 + analyser_height;
+
+   #if MBC_ENABLE_INSTRUMENTATION
+    // When instrumentation is built in, we show the stage timings
+    // underneath the controls:
+    height += PerformanceOverlay::getIdealHeight(processor.getPerformanceMonitor());
+   #endif
+
+    setSize (width, height);
+
+   #if MBC_ENABLE_INSTRUMENTATION
+    construction_ticks_ = Time::getHighResolutionTicks() - editor_start_ticks;
+   #endif
+}
+
+void MultibandCompressorAudioProcessorEditor::createControlsIfShowing()
+{
+    if (has_controls_ || ! isShowing())
+        return;
+    has_controls_ = true;
+
+   #if MBC_ENABLE_INSTRUMENTATION
+    auto controls_start_ticks = Time::getHighResolutionTicks();
+   #endif
+
+    auto num_compressors = processor.compressors_.size();
 
     // First we create as many compressor editors as we have compressors:
     for (auto i = 0; i < num_compressors; i++)
@@ -14,9 +53,8 @@ MultibandCompressorAudioProcessorEditor::MultibandCompressorAudioProcessorEditor
         auto index = std::to_string(i + 1);
         auto name = "Band " + index;
 
-        // Get a reference to our compressor processor:
-        auto compressor_processor = dynamic_cast<CompressorProcessor*>(
-            processor.compressor_nodes_[i]->getProcessor());
+        // Get a pointer to our compressor processor:
+        auto compressor_processor = processor.compressors_[i];
 
         // Setup our compressor editor:
         auto compressor_editor = new CompressorComponent(
@@ -26,7 +64,7 @@ MultibandCompressorAudioProcessorEditor::MultibandCompressorAudioProcessorEditor
         // Add it to our UI
         addAndMakeVisible(compressor_editor);
         // Hook up its controls to the parameters of the processor
-        compressor_editor->attachToProcessor();
+        compressor_editor->attachToProcessor(parameter_bindings_);
         // Store it in a juce::OwnedArray
         compressor_editors_.add(compressor_editor);
     }
@@ -34,39 +72,61 @@ MultibandCompressorAudioProcessorEditor::MultibandCompressorAudioProcessorEditor
     // Then we create as many frequency sliders as we have crossover filters:
     for (auto i = 0; i < num_compressors - 1; i++)
     {
-        // Logarithmically divide up the frequency range:
-        auto initial_value = 40.0 + pow(
-            2,
-            (i + 3) * log2(19960.0) / (num_compressors + 2));
-
         // Get a pointer to the appropriate CrossoverFilterProcessor
-        auto crossover_processor = dynamic_cast<CrossoverFilterProcessor*>(
-            processor.crossover_nodes_[i]->getProcessor());
+        auto crossover_processor = processor.crossovers_[i];
 
         // Create a slider UI control 
         auto index = std::to_string(i + 1);
         auto crossover_slider = new Slider("crossover_" + index);
-        // And set all the appropriate parameters:
+        // And set all the appropriate parameters. Its range and value come
+        // from the crossover's frequency parameter, which it's bound to:
         crossover_slider->setSliderStyle(Slider::LinearBar);
-        crossover_slider->setRange(40.0, 20000.0, 1.0);
-        crossover_slider->setValue(initial_value);
         crossover_slider->setTextValueSuffix(" Hz");
         crossover_slider->setSkewFactor(0.4);
         addAndMakeVisible(crossover_slider);
-
-        crossover_slider->onValueChange =
-            [crossover_processor, crossover_slider] {
-                *(crossover_processor->cutoff_frequency_in_hz_) =
-                    crossover_slider->getValue();
-            };
+        parameter_bindings_.bind(
+            *crossover_slider,
+            *crossover_processor->cutoff_frequency_in_hz_,
+            1.0);
 
         // Add it to a juce::OwnedArray.
         crossover_sliders_.add(crossover_slider);
     }
 
-    // Set our editor width based on the number of compressors we have:
-    auto width = num_compressors * 220 + 10;
-    setSize (width, 230);
+    // And a switch between splitting into bands and compressing every FFT
+    // bin separately:
+    parameter_bindings_.bind(spectral_mode_button_, *processor.spectral_mode_);
+    addAndMakeVisible(spectral_mode_button_);
+
+    // And one to let slow bands run their sidechains at a control rate:
+    parameter_bindings_.bind(
+        control_rate_button_,
+        *processor.control_rate_sidechain_);
+    addAndMakeVisible(control_rate_button_);
+
+    // Underneath the controls, a spectrum of our input with the crossovers
+    // and each band's level drawn over it:
+    spectrum_analyser_ = std::make_unique<SpectrumAnalyser>(
+        processor.getAnalyserTap(),
+        processor.crossovers_);
+    addAndMakeVisible(spectrum_analyser_.get());
+
+   #if MBC_ENABLE_INSTRUMENTATION
+    performance_overlay_ = std::make_unique<PerformanceOverlay>(
+        processor.getPerformanceMonitor());
+    addAndMakeVisible(performance_overlay_.get());
+    spectrum_analyser_->setPerformanceMonitor(
+        &processor.getPerformanceMonitor());
+   #endif
+
+    resized();
+
+   #if MBC_ENABLE_INSTRUMENTATION
+    processor.getPerformanceMonitor().setStartupTime(
+        PerformanceMonitor::editor_opening,
+        construction_ticks_
+            + Time::getHighResolutionTicks() - controls_start_ticks);
+   #endif
 }
 
 MultibandCompressorAudioProcessorEditor::~MultibandCompressorAudioProcessorEditor()
@@ -79,10 +139,25 @@ void MultibandCompressorAudioProcessorEditor::paint (Graphics& g)
     g.fillAll(getLookAndFeel().findColour(ResizableWindow::backgroundColourId));
 }
 
+void MultibandCompressorAudioProcessorEditor::visibilityChanged()
+{
+    createControlsIfShowing();
+}
+
+void MultibandCompressorAudioProcessorEditor::parentHierarchyChanged()
+{
+    // This is how we hear about the host putting our window on screen
+    createControlsIfShowing();
+}
+
 void MultibandCompressorAudioProcessorEditor::resized()
 {
+    // Until we've been shown, there's nothing to lay out
+    if (! has_controls_)
+        return;
+
     // Iterate over our compressors editors and position them:
-    auto num_compressors = processor.compressor_nodes_.size();
+    auto num_compressors = processor.compressors_.size();
     for (auto i = 0; i < num_compressors; i++)
     {
         auto start = 10 + i * 220;
@@ -90,10 +165,24 @@ void MultibandCompressorAudioProcessorEditor::resized()
     }
 
     // Iterate over our crossover sliders and position them:
-    auto num_crossovers = processor.crossover_nodes_.size();
+    auto num_crossovers = processor.crossovers_.size();
     for (auto i = 0; i < num_crossovers; i++)
     {
         auto start = 185 + i * 220;
         crossover_sliders_[i]->setBounds(start, 190, 90, 30);
     }
+
+    spectral_mode_button_.setBounds(10, 190, 80, 30);
+    control_rate_button_.setBounds(90, 190, 90, 30);
+
+    spectrum_analyser_->setBounds(
+        10,
+        230,
+        getWidth() - 20,
+        analyser_height - 10);
+
+   #if MBC_ENABLE_INSTRUMENTATION
+    performance_overlay_->setBounds(
+        getLocalBounds().withTrimmedTop(230 + analyser_height));
+   #endif
 }
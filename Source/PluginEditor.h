@@ -3,6 +3,9 @@
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
 #include "CompressorComponent.h"
+#include "ParameterBindings.h"
+#include "PerformanceOverlay.h"
+#include "SpectrumAnalyser.h"
 
 //==============================================================================
 /**
@@ -16,12 +19,35 @@ public:
     //==============================================================================
     void paint (Graphics&) override;
     void resized() override;
+    void visibilityChanged() override;
+    void parentHierarchyChanged() override;
 
 private:
+    void createControlsIfShowing();
+
     MultibandCompressorAudioProcessor& processor;
 
+    // Our controls and displays are only built the first time we're
+    // actually shown. Hosts often create editors they never show, or
+    // create every instance's editor while loading a session.
+    bool has_controls_ = false;
+
     OwnedArray<CompressorComponent> compressor_editors_;
     OwnedArray<Slider> crossover_sliders_;
+    ToggleButton spectral_mode_button_ {"Spectral"};
+    ToggleButton control_rate_button_ {"Ctrl Rate"};
+    std::unique_ptr<SpectrumAnalyser> spectrum_analyser_;
+
+   #if MBC_ENABLE_INSTRUMENTATION
+    std::unique_ptr<PerformanceOverlay> performance_overlay_;
+    // How long our constructor took, added to the time taken to build
+    // our controls to give the editor's opening time
+    int64 construction_ticks_ = 0;
+   #endif
+
+    // Keeps every control in step with its parameter. Declared last, so
+    // that it lets go of the controls before they're destroyed.
+    ParameterBindings parameter_bindings_;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MultibandCompressorAudioProcessorEditor)
 };
@@ -1,5 +1,7 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "BandSplitEngine.h"
+#include "SpectralEngine.h"
 
 #define NUM_COMPRESSORS 5
 #define NUM_CROSSOVERS NUM_COMPRESSORS - 1
@@ -8,14 +10,21 @@
 MultibandCompressorAudioProcessor::MultibandCompressorAudioProcessor()
     : AudioProcessor (BusesProperties()
                     .withInput  ("Input",  AudioChannelSet::stereo(), true)
-                    .withOutput ("Output", AudioChannelSet::stereo(), true)),
-      processor_graph_ (std::make_unique<AudioProcessorGraph>())
+                    .withOutput ("Output", AudioChannelSet::stereo(), true))
 {
     // To setup the plugin processor, we need to create our compressors and
     // crossover filters. These are all assigned dynamically, so we can set
     // the number of compressors using the NUM_COMPRESSORS macro at the top of
-    // this file. The AudioProcessorGraph and the plugin's editor will then
+    // this file. Our processing and the plugin's editor will then
     // automatically adapt.
+    //
+    // We only create the processors themselves here, since the host needs
+    // their parameters straight away. None of them allocate any audio
+    // buffers or DSP state until we're first prepared, so loading a session
+    // full of instances stays cheap.
+   #if MBC_ENABLE_INSTRUMENTATION
+    auto construction_start_ticks = Time::getHighResolutionTicks();
+   #endif
 
     // First we create NUM_COMPRESSORS compressors:
     for (auto i = 0; i < NUM_COMPRESSORS; i++)
@@ -26,26 +35,125 @@ MultibandCompressorAudioProcessor::MultibandCompressorAudioProcessor()
         // Pull out its parameters
         addParameterGroup(compressor_processor->getParameterTree());
 
-        // Add them to the processor graph and store a reference to the
-        // resulting node.
-        compressor_nodes_.add(
-            processor_graph_->addNode(std::move(compressor_processor))); 
+        // Keep a typed pointer to it, and hold on to it for as long as we
+        // live. It holds its band's parameters, but the audio is processed
+        // by whichever engine is playing.
+        compressors_.add(compressor_processor.get());
+        compressor_processors_.push_back(std::move(compressor_processor));
     }
 
-    // We do exactly the same for our crossover filters, but we store their
-    // nodes in a separate juce::Array, so that we can easily access them:
+    addParameter(control_rate_sidechain_ = new AudioParameterBool(
+        "control_rate_sidechain",
+        "Control Rate Sidechain",
+        false));
+
+    // We do exactly the same for our crossover filters, but we store them
+    // in a separate juce::Array, so that we can easily access them. Like
+    // the compressors, these only hold their parameters: each engine we
+    // build makes crossovers of its own that follow them.
     for (auto i = 0; i < NUM_CROSSOVERS; i++)
     {
-        auto crossover_processor =
-            std::make_unique<CrossoverFilterProcessor>(i);
+        // Our crossovers start out logarithmically dividing up the
+        // frequency range:
+        auto default_cutoff_in_hz = 40.0 + pow(
+            2,
+            (i + 3) * log2(19960.0) / (NUM_COMPRESSORS + 2));
+        auto crossover_processor = std::make_unique<CrossoverFilterProcessor>(
+            i,
+            (float) default_cutoff_in_hz);
         addParameterGroup(crossover_processor->getParameterTree());
-        crossover_nodes_.add(
-            processor_graph_->addNode(std::move(crossover_processor)));
+        crossovers_.add(crossover_processor.get());
+        crossover_processors_.push_back(std::move(crossover_processor));
     }
+
+    // Our crossovers still need to know about each other's phase
+    // compensation, so they can tell us how long their tails are:
+    for (auto i = 0; i < crossovers_.size(); i++)
+        for (auto j = i + 1; j < crossovers_.size(); j++)
+            crossovers_[i]->addPhaseCompensationFor(*crossovers_[j]);
+
+   #if MBC_ENABLE_INSTRUMENTATION
+    // Every engine we build shares the same stages, so we only add them
+    // once:
+    performance_stages_.monitor = &performance_monitor_;
+    performance_stages_.compressors = performance_monitor_.addStage("Compressors");
+    for (auto i = 0; i < crossovers_.size(); i++)
+        performance_stages_.crossovers.add(
+            performance_monitor_.addStage("Crossover " + String(i + 1)));
+    performance_stages_.summing = performance_monitor_.addStage("Summing");
+   #endif
+
+    // Bands that are dynamic EQs are shaped by their own filters before we
+    // split, using the crossover frequencies either side as their region:
+    dynamic_eq_ = std::make_unique<DynamicEqProcessor>(
+        compressors_,
+        crossovers_);
+   #if MBC_ENABLE_INSTRUMENTATION
+    dynamic_eq_->setPerformanceMonitor(
+        &performance_monitor_,
+        performance_monitor_.addStage("Dynamic EQ"));
+    performance_stages_.spectral = performance_monitor_.addStage("Spectral");
+    analyser_stage_ = performance_monitor_.addStage("Analyser tap");
+   #endif
+    addParameter(spectral_mode_ = new AudioParameterBool(
+        "spectral_mode",
+        "Spectral Mode",
+        false));
+
+    // The multiband processing itself is done by an engine: either the
+    // crossovers and compressor bank, or the spectral engine. Our engine
+    // swapper builds whichever one spectral mode asks for on a thread of
+    // its own, and crossfades over to it when it's ready. Any change in
+    // latency is reported from the message thread.
+    engine_swapper_ = std::make_unique<EngineSwapper>(
+        [this] {
+            return spectral_mode_->get() ? spectral_engine : band_split_engine;
+        },
+        [this] (int engine_id) { return createEngine(engine_id); },
+        [this] (int latency_in_samples) { setLatencySamples(latency_in_samples); });
+    // The swapper's builder thread sleeps until spectral mode changes
+    spectral_mode_->addListener(this);
+
+   #if MBC_ENABLE_INSTRUMENTATION
+    performance_monitor_.setStartupTime(
+        PerformanceMonitor::construction,
+        Time::getHighResolutionTicks() - construction_start_ticks);
+   #endif
 }
 
 MultibandCompressorAudioProcessor::~MultibandCompressorAudioProcessor()
 {
+    spectral_mode_->removeListener(this);
+}
+
+void MultibandCompressorAudioProcessor::parameterValueChanged (
+    int parameterIndex,
+    float newValue)
+{
+    // Only spectral mode is listened to. This may be on the audio thread,
+    // so the swapper wakes its builder thread from the message thread.
+    engine_swapper_->chosenEngineMayHaveChanged();
+}
+
+std::unique_ptr<MultibandEngine> MultibandCompressorAudioProcessor::createEngine (
+    int engine_id)
+{
+    // Both engines take their settings from our compressors, and use our
+    // crossover frequencies to tell where one band ends and the next
+    // begins.
+    std::unique_ptr<MultibandEngine> engine;
+    if (engine_id == spectral_engine)
+        engine = std::make_unique<SpectralEngine>(compressors_, crossovers_);
+    else
+        engine = std::make_unique<BandSplitEngine>(
+            compressors_,
+            crossovers_,
+            control_rate_sidechain_);
+
+   #if MBC_ENABLE_INSTRUMENTATION
+    engine->setPerformanceStages(performance_stages_);
+   #endif
+    return engine;
 }
 
 //==============================================================================
@@ -83,7 +191,19 @@ bool MultibandCompressorAudioProcessor::isMidiEffect() const
 
 double MultibandCompressorAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    // Our crossovers are in series, so we allow for each one's ringing in
+    // turn, plus however long our latency holds the output back. The
+    // compressors have no tail: silence in always gives silence out. The
+    // spectral engine doesn't ring either, since the last frame a sample
+    // touches is finished within our latency. The dynamic EQ comes before
+    // either engine, so its ringing is added on top.
+    auto tail_in_seconds = dynamic_eq_->getTailLengthSeconds();
+    if (engine_swapper_->getEngineId() != spectral_engine)
+        for (auto crossover : crossovers_)
+            tail_in_seconds += crossover->getTailLengthSeconds();
+    if (getSampleRate() > 0.0)
+        tail_in_seconds += getLatencySamples() / getSampleRate();
+    return tail_in_seconds;
 }
 
 int MultibandCompressorAudioProcessor::getNumPrograms()
@@ -112,21 +232,46 @@ void MultibandCompressorAudioProcessor::changeProgramName (int index, const Stri
 //==============================================================================
 void MultibandCompressorAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
-    // We tell the graph how many input and output channels we would like,
-    // and initialise it:
-    processor_graph_->setPlayConfigDetails(
-        getMainBusNumInputChannels(),
-        getMainBusNumOutputChannels(),
-        sampleRate,
-        samplesPerBlock);
-    initialiseGraph();
-    processor_graph_->prepareToPlay(sampleRate, samplesPerBlock);
+   #if MBC_ENABLE_INSTRUMENTATION
+    auto preparation_start_ticks = Time::getHighResolutionTicks();
+   #endif
 
+    // The dynamic EQ works on the host's stereo buffer directly
+    dynamic_eq_->setPlayConfigDetails(2, 2, sampleRate, samplesPerBlock);
+    dynamic_eq_->prepareToPlay(sampleRate, samplesPerBlock);
+    analyser_tap_.prepare(sampleRate);
+
+    // We're not processing, so our engine swapper builds the engine the
+    // user asked for straight away, in the precision the host has asked
+    // for, and reports its latency. From here on it watches for the user
+    // switching engines on its own thread.
+    engine_swapper_->prepare(
+        sampleRate,
+        samplesPerBlock,
+        getProcessingPrecision() == doublePrecision);
+
+    // Make sure we start from a clean slate, with no filter or envelope
+    // state left over from the last time we played:
+    reset();
+
+   #if MBC_ENABLE_INSTRUMENTATION
+    performance_monitor_.prepare(sampleRate);
+    performance_monitor_.setStartupTime(
+        PerformanceMonitor::preparation,
+        Time::getHighResolutionTicks() - preparation_start_ticks);
+   #endif
 }
 
 void MultibandCompressorAudioProcessor::releaseResources()
 {
-    processor_graph_->releaseResources();
+    engine_swapper_->release();
+    dynamic_eq_->releaseResources();
+}
+
+void MultibandCompressorAudioProcessor::reset()
+{
+    engine_swapper_->reset();
+    dynamic_eq_->reset();
 }
 
 bool MultibandCompressorAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
@@ -141,7 +286,26 @@ bool MultibandCompressorAudioProcessor::isBusesLayoutSupported (const BusesLayou
     return true;
 }
 
+bool MultibandCompressorAudioProcessor::supportsDoublePrecisionProcessing() const
+{
+    // Every one of our stages can work natively in double precision
+    return true;
+}
+
 void MultibandCompressorAudioProcessor::processBlock (AudioBuffer<float>& buffer, MidiBuffer& midiMessages)
+{
+    process (buffer, midiMessages);
+}
+
+void MultibandCompressorAudioProcessor::processBlock (AudioBuffer<double>& buffer, MidiBuffer& midiMessages)
+{
+    process (buffer, midiMessages);
+}
+
+template <typename FloatType>
+void MultibandCompressorAudioProcessor::process (
+    AudioBuffer<FloatType>& buffer,
+    MidiBuffer& midiMessages)
 {
     // Thanks to abstractions, our processBlock is pretty simple.
 
@@ -154,9 +318,37 @@ void MultibandCompressorAudioProcessor::processBlock (AudioBuffer<float>& buffer
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
-    // Then, we simply pass our buffer into our processor graph, and it will
-    // cascade through all of our processors.
-    processor_graph_->processBlock(buffer, midiMessages);
+   #if MBC_ENABLE_INSTRUMENTATION
+    performance_monitor_.beginBlock();
+    auto block_start_ticks = Time::getHighResolutionTicks();
+   #endif
+
+    // If the editor's spectrum analyser is open, we hand it a mono copy of
+    // our input. The analysis itself happens on the message thread, so
+    // this is all it costs us, and its own stage shows that's no more than
+    // a copy of the block.
+    {
+        MBC_TIME_STAGE(&performance_monitor_, analyser_stage_);
+        analyser_tap_.push(buffer);
+    }
+
+    // Dynamic EQ bands are shaped first, on the whole signal, whichever
+    // engine then does the rest.
+    dynamic_eq_->processBlock(buffer, midiMessages);
+
+    // Then the engine does the multiband processing proper. If the user
+    // has just switched engines, the swapper crossfades from the old one
+    // to the new one here.
+    engine_swapper_->process(buffer);
+
+   #if MBC_ENABLE_INSTRUMENTATION
+    // Each stage has timed itself, so we only need the total here. Whatever
+    // is left over is copying our input in and the cost of getting from one
+    // stage to the next.
+    performance_monitor_.endBlock(
+        Time::getHighResolutionTicks() - block_start_ticks,
+        buffer.getNumSamples());
+   #endif
 }
 
 //==============================================================================
@@ -179,92 +371,6 @@ void MultibandCompressorAudioProcessor::setStateInformation (const void* data, i
 {
 }
 
-void MultibandCompressorAudioProcessor::initialiseGraph()
-{
-    // Simply iterate over our compressor and crossover nodes, calling
-    // setPlayConfigDetails.
-    for (auto& node : compressor_nodes_)
-    {
-        node->getProcessor()->setPlayConfigDetails(
-            getMainBusNumInputChannels(),
-            getMainBusNumOutputChannels(),
-            getSampleRate(),
-            getBlockSize());
-    }
-    for (auto& node : crossover_nodes_)
-    {
-        // Note that each crossover takes a stereo input and gives two stereo
-        // outputs
-        node->getProcessor()->setPlayConfigDetails(
-            2,
-            4,
-            getSampleRate(),
-            getBlockSize());
-    }
-
-    // We setup our input and output nodes, and connect up our graph:
-    audio_input_node_ = processor_graph_->addNode(
-        std::make_unique<AudioGraphIOProcessor>(
-            AudioGraphIOProcessor::audioInputNode));
-    audio_output_node_ = processor_graph_->addNode(
-        std::make_unique<AudioGraphIOProcessor>(
-            AudioGraphIOProcessor::audioOutputNode));
-
-    connectAudioNodes();
-}
-
-void MultibandCompressorAudioProcessor::connectAudioNodes()
-{
-    // Firstly, we setup our input node, and connect it to our first crossover
-    for (auto channel = 0; channel < 2; channel++)
-        processor_graph_->addConnection(
-            {{audio_input_node_->nodeID, channel},
-            {crossover_nodes_[0]->nodeID, channel}});
-
-    // Then we iterate over our crossovers and channels: 
-    for (auto i = 0; i < crossover_nodes_.size(); i++)
-    {
-        for (auto channel = 0; channel < 2; channel++)
-        {
-            // For the first stereo output of each crossover, we connect it
-            // to the compressor with the same index:
-            processor_graph_->addConnection(
-                {{crossover_nodes_[i]->nodeID, channel},
-                {compressor_nodes_[i]->nodeID, channel}});
-            
-            if (i < crossover_nodes_.size() - 1)
-            {
-                // For the second stereo output, if we are not at our last
-                // crossover filter, we connect it to the next crossover...
-                processor_graph_->addConnection(
-                    {{crossover_nodes_[i]->nodeID, channel + 2},
-                    {crossover_nodes_[i + 1]->nodeID, channel}});
-            } else
-            {
-                // But if it's our last crossover, we connect its high pass
-                // output to our final compressor
-                processor_graph_->addConnection(
-                    {{crossover_nodes_[i]->nodeID, channel + 2},
-                    {compressor_nodes_[i + 1]->nodeID, channel}});
-            }
-            
-        }
-    }
-
-    // And finally, we sum the outputs of all our compressors:
-    for (auto& compressor_node : compressor_nodes_)
-    {
-        for (auto channel = 0; channel < 2; channel++)
-            processor_graph_->addConnection(
-                {{compressor_node->nodeID, channel},
-                {audio_output_node_->nodeID, channel}});
-    }
-}
-
-void MultibandCompressorAudioProcessor::updateGraph()
-{
-}
-
 //==============================================================================
 // This creates new instances of the plugin..
 AudioProcessor* JUCE_CALLTYPE createPluginFilter()
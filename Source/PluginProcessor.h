@@ -1,15 +1,19 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "AnalyserTap.h"
 #include "CompressorProcessor.h"
 #include "CrossoverFilterProcessor.h"
+#include "DynamicEqProcessor.h"
+#include "EngineSwapper.h"
+#include "MultibandEngine.h"
+#include "PerformanceMonitor.h"
 
-using AudioGraphIOProcessor = AudioProcessorGraph::AudioGraphIOProcessor;
-using Node = AudioProcessorGraph::Node;
 //==============================================================================
 /**
 */
-class MultibandCompressorAudioProcessor  : public AudioProcessor
+class MultibandCompressorAudioProcessor  : public AudioProcessor,
+                                           private AudioProcessorParameter::Listener
 {
 public:
     //==============================================================================
@@ -19,12 +23,15 @@ public:
     //==============================================================================
     void prepareToPlay (double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
+    void reset() override;
 
    #ifndef JucePlugin_PreferredChannelConfigurations
     bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
    #endif
 
     void processBlock (AudioBuffer<float>&, MidiBuffer&) override;
+    void processBlock (AudioBuffer<double>&, MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override;
 
     //==============================================================================
     AudioProcessorEditor* createEditor() override;
@@ -49,18 +56,60 @@ public:
     void getStateInformation (MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
 
-    Array<Node::Ptr> crossover_nodes_;
-    Array<Node::Ptr> compressor_nodes_;
+    // Typed pointers to our crossovers and compressors, so the editor can
+    // get straight at them without any casting. These only hold each
+    // band's and crossover's parameters: the audio itself is processed by
+    // whichever MultibandEngine is playing, which has filters and
+    // compressors of its own.
+    Array<CrossoverFilterProcessor*> crossovers_;
+    Array<CompressorProcessor*> compressors_;
+
+    // Whether to compress every FFT bin separately instead of splitting
+    // into bands with the crossovers. The bands' settings are used either
+    // way.
+    AudioParameterBool* spectral_mode_;
+    // Whether the compressor bank may run its slower bands' sidechains at a
+    // decimated control rate
+    AudioParameterBool* control_rate_sidechain_;
+
+    // Where the editor's spectrum analyser gets our input from
+    AnalyserTap& getAnalyserTap() { return analyser_tap_; }
+
+   #if MBC_ENABLE_INSTRUMENTATION
+    PerformanceMonitor& getPerformanceMonitor() { return performance_monitor_; }
+   #endif
 
 private:
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MultibandCompressorAudioProcessor)
-    void initialiseGraph();
-    void connectAudioNodes();
-    void updateGraph();
 
-    std::unique_ptr<AudioProcessorGraph> processor_graph_;
+    // The kinds of MultibandEngine we can swap between
+    enum EngineId
+    {
+        band_split_engine = 0,
+        spectral_engine
+    };
+
+    std::unique_ptr<MultibandEngine> createEngine (int engine_id);
+    void parameterValueChanged (int parameterIndex, float newValue) override;
+    void parameterGestureChanged (int, bool) override {}
+    template <typename FloatType>
+    void process (AudioBuffer<FloatType>&, MidiBuffer&);
+
+    std::vector<std::unique_ptr<CompressorProcessor>> compressor_processors_;
+    std::vector<std::unique_ptr<CrossoverFilterProcessor>> crossover_processors_;
+    std::unique_ptr<DynamicEqProcessor> dynamic_eq_;
+    AnalyserTap analyser_tap_;
+
+   #if MBC_ENABLE_INSTRUMENTATION
+    PerformanceMonitor performance_monitor_;
+    int analyser_stage_ = -1;
+    // Every engine we build records its timings into the same stages
+    MultibandEngine::PerformanceStages performance_stages_;
+   #endif
 
-    Node::Ptr audio_input_node_;
-    Node::Ptr audio_output_node_;
+    // Builds whichever engine the user asks for in the background, and
+    // crossfades over to it. Declared last, so that it's destroyed (and
+    // its builder thread stopped) before anything its engines use.
+    std::unique_ptr<EngineSwapper> engine_swapper_;
 };
@@ -18,6 +18,7 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "PerformanceMonitor.h"
 
 class ProcessorBase : public AudioProcessor
 {
@@ -46,6 +47,19 @@ public:
     void getStateInformation (MemoryBlock& destData) override             {}
     void setStateInformation (const void* data, int sizeInBytes) override {}
 
+   #if MBC_ENABLE_INSTRUMENTATION
+    // Lets the plugin tell each stage where to record its timings
+    void setPerformanceMonitor(PerformanceMonitor* monitor, int stage)
+    {
+        performance_monitor_ = monitor;
+        performance_stage_ = stage;
+    }
+
+protected:
+    PerformanceMonitor* performance_monitor_ = nullptr;
+    int performance_stage_ = -1;
+   #endif
+
 private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ProcessorBase)
 };
\ No newline at end of file
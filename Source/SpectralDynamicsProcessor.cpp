@@ -0,0 +1,413 @@
+/*
+  ==============================================================================
+
+    SpectralDynamicsProcessor.cpp
+    Created: 19 Oct 2026 1:49:46pm
+    Author:  Ben Hayes
+
+  ==============================================================================
+*/
+
+#include "SpectralDynamicsProcessor.h"
+
+bool SpectralDynamicsProcessor::BandSettings::operator== (
+    const BandSettings& other) const noexcept
+{
+    return threshold_in_db == other.threshold_in_db
+        && ratio == other.ratio
+        && knee_in_db == other.knee_in_db
+        && lower_mode == other.lower_mode
+        && lower_threshold_in_db == other.lower_threshold_in_db
+        && lower_ratio == other.lower_ratio
+        && lower_range_in_db == other.lower_range_in_db
+        && attack_in_seconds == other.attack_in_seconds
+        && release_in_seconds == other.release_in_seconds
+        && auto_release == other.auto_release;
+}
+
+SpectralDynamicsProcessor::SpectralDynamicsProcessor(
+    const Array<CompressorProcessor*>& compressors,
+    const Array<CrossoverFilterProcessor*>& crossovers)
+    : compressors_ (compressors),
+      crossovers_ (crossovers)
+{
+}
+
+SpectralDynamicsProcessor::~SpectralDynamicsProcessor()
+{
+    releaseResources();
+}
+
+void SpectralDynamicsProcessor::prepareToPlay(
+    double sampleRate,
+    int samplesPerBlock)
+{
+    sample_rate_in_hz_ = sampleRate;
+
+    // Periodic square root Hann windows. With frames a quarter of a frame
+    // apart, the products of the two windows overlap-add to a constant,
+    // which we divide out of the synthesis window.
+    analysis_window_.resize((size_t) fft_size);
+    synthesis_window_.resize((size_t) fft_size);
+    auto window_sum = 0.0;
+    for (auto i = 0; i < fft_size; i++)
+    {
+        auto hann = 0.5 - 0.5 * std::cos(
+            MathConstants<double>::twoPi * i / fft_size);
+        analysis_window_[(size_t) i] = (float) std::sqrt(hann);
+        window_sum += std::sqrt(hann);
+    }
+    auto overlap_sum = 0.0f;
+    for (auto i = 0; i < fft_size; i += hop_size)
+        overlap_sum += analysis_window_[(size_t) i] * analysis_window_[(size_t) i];
+    for (auto i = 0; i < fft_size; i++)
+        synthesis_window_[(size_t) i] = analysis_window_[(size_t) i] / overlap_sum;
+
+    // A sine of peak amplitude A gives a bin magnitude of A times half the
+    // window's sum:
+    level_scale_ = (float) (2.0 / window_sum);
+
+    for (auto channel = 0; channel < 2; channel++)
+    {
+        input_fifos_[channel].assign((size_t) fft_size, 0.0f);
+        output_fifos_[channel].assign((size_t) fft_size, 0.0f);
+        // The FFT works in place, and needs room for twice its size
+        frames_[channel].assign((size_t) (2 * fft_size), 0.0f);
+    }
+    power_.assign((size_t) (2 * fft_size), 0.0f);
+    interleaved_gains_.assign((size_t) (2 * fft_size), 1.0f);
+
+    // One bin per lane, rounded up to whole registers. The spare lanes are
+    // never given any settings, so they compute a gain of 0dB.
+    auto lanes_per_register = (int) Register::SIMDNumElements;
+    num_registers_ = (num_bins + lanes_per_register - 1) / lanes_per_register;
+    if (kernels_ == nullptr)
+    {
+        kernels_ = allocateRegisterAligned<Kernel>(
+            kernel_memory_,
+            (size_t) num_registers_);
+        for (auto i = 0; i < num_registers_; i++)
+            new (kernels_ + i) Kernel();
+
+        control_ = allocateRegisterAligned<float>(
+            control_memory_,
+            (size_t) (num_registers_ * lanes_per_register));
+    }
+    std::fill(
+        control_,
+        control_ + num_registers_ * lanes_per_register,
+        DecibelTables::minus_infinity_db);
+
+    // Forget our cached settings, so that every bin picks them up again at
+    // the new sample rate:
+    bin_bands_.assign((size_t) num_bins, 0);
+    band_cutoffs_in_hz_.assign((size_t) crossovers_.size(), 0.0f);
+    band_settings_.assign((size_t) compressors_.size(), BandSettings());
+    band_makeup_gains_in_db_.assign((size_t) compressors_.size(), 0.0f);
+    band_states_.assign((size_t) compressors_.size(), BandState::compressed);
+
+    // We can only give a frame back once we've heard all of it
+    setLatencySamples(fft_size);
+
+    reset();
+}
+
+void SpectralDynamicsProcessor::releaseResources()
+{
+    for (auto i = 0; i < num_registers_ && kernels_ != nullptr; i++)
+        kernels_[i].~Kernel();
+    kernels_ = nullptr;
+    control_ = nullptr;
+    kernel_memory_.free();
+    control_memory_.free();
+}
+
+void SpectralDynamicsProcessor::reset()
+{
+    for (auto channel = 0; channel < 2; channel++)
+    {
+        std::fill(input_fifos_[channel].begin(), input_fifos_[channel].end(), 0.0f);
+        std::fill(output_fifos_[channel].begin(), output_fifos_[channel].end(), 0.0f);
+    }
+    fifo_position_ = 0;
+    hop_position_ = 0;
+
+    for (auto i = 0; i < num_registers_ && kernels_ != nullptr; i++)
+        kernels_[i].gain_smoother.reset();
+}
+
+void SpectralDynamicsProcessor::processBlock(
+    AudioBuffer<float>& buffer,
+    MidiBuffer& midiMessages)
+{
+    process(buffer);
+}
+
+void SpectralDynamicsProcessor::processBlock(
+    AudioBuffer<double>& buffer,
+    MidiBuffer& midiMessages)
+{
+    process(buffer);
+}
+
+template <typename FloatType>
+void SpectralDynamicsProcessor::process(AudioBuffer<FloatType>& buffer)
+{
+    MBC_TIME_STAGE(performance_monitor_, performance_stage_);
+
+    jassert(kernels_ != nullptr);
+
+    // With a mono input, the right channel's FIFOs just stay silent, and
+    // each frame only transforms and measures the one channel we have.
+    auto num_channels = jmin(2, buffer.getNumChannels());
+    if (num_channels == 0)
+        return;
+    num_input_channels_ = num_channels;
+
+    for (auto n = 0; n < buffer.getNumSamples(); n++)
+    {
+        // Each new sample goes into the input FIFO, and the sample that's
+        // finished being overlap-added comes out of the output FIFO in its
+        // place.
+        for (auto channel = 0; channel < 2; channel++)
+        {
+            auto& input_fifo = input_fifos_[channel];
+            auto& output_fifo = output_fifos_[channel];
+
+            input_fifo[(size_t) fifo_position_] = channel < num_channels
+                ? (float) buffer.getSample(channel, n)
+                : 0.0f;
+            if (channel < num_channels)
+                buffer.setSample(
+                    channel,
+                    n,
+                    (FloatType) output_fifo[(size_t) fifo_position_]);
+            output_fifo[(size_t) fifo_position_] = 0.0f;
+        }
+
+        if (++fifo_position_ == fft_size)
+            fifo_position_ = 0;
+
+        if (++hop_position_ == hop_size)
+        {
+            hop_position_ = 0;
+            processFrame();
+        }
+    }
+}
+
+void SpectralDynamicsProcessor::processFrame()
+{
+    updateBinSettings();
+
+    // Window the last fft_size samples of each channel, oldest first, and
+    // transform them. The FIFO position is the oldest sample.
+    for (auto channel = 0; channel < num_input_channels_; channel++)
+    {
+        auto frame = frames_[channel].data();
+        auto input = input_fifos_[channel].data();
+        auto first_part = fft_size - fifo_position_;
+        FloatVectorOperations::multiply(
+            frame,
+            input + fifo_position_,
+            analysis_window_.data(),
+            first_part);
+        FloatVectorOperations::multiply(
+            frame + first_part,
+            input,
+            analysis_window_.data() + first_part,
+            fifo_position_);
+        fft_.performRealOnlyForwardTransform(frame, true);
+    }
+
+    // Each bin's level is the magnitude of the mean of our channels'
+    // powers. Squaring and adding the interleaved real and imaginary parts
+    // is done a whole register at a time; only pairing them up is scalar.
+    auto num_values = 2 * num_bins;
+    FloatVectorOperations::multiply(
+        power_.data(),
+        frames_[0].data(),
+        frames_[0].data(),
+        num_values);
+    if (num_input_channels_ > 1)
+        FloatVectorOperations::addWithMultiply(
+            power_.data(),
+            frames_[1].data(),
+            frames_[1].data(),
+            num_values);
+    auto channel_scale = 1.0f / (float) num_input_channels_;
+    for (auto bin = 0; bin < num_bins; bin++)
+    {
+        auto power = channel_scale
+            * (power_[(size_t) (2 * bin)] + power_[(size_t) (2 * bin + 1)]);
+        control_[bin] = decibel_tables_->gainToDecibels(
+            std::sqrt(power) * level_scale_);
+    }
+
+    computeGains();
+
+    // Turn each bin's gain into a linear gain on both its real and
+    // imaginary parts, so it can be applied to the interleaved spectrum in
+    // one vector multiply:
+    for (auto bin = 0; bin < num_bins; bin++)
+    {
+        auto band = bin_bands_[(size_t) bin];
+        auto gain = 0.0f;
+        switch (band_states_[(size_t) band])
+        {
+            case BandState::silent:
+                gain = 0.0f;
+                break;
+            case BandState::bypassed:
+                gain = 1.0f;
+                break;
+            case BandState::compressed:
+                gain = decibel_tables_->decibelsToGain(
+                    band_makeup_gains_in_db_[(size_t) band] + control_[bin]);
+                break;
+        }
+        interleaved_gains_[(size_t) (2 * bin)] = gain;
+        interleaved_gains_[(size_t) (2 * bin + 1)] = gain;
+    }
+
+    // Then apply the gains, transform back, and overlap-add the windowed
+    // result into the output FIFO, starting from the oldest sample.
+    for (auto channel = 0; channel < num_input_channels_; channel++)
+    {
+        auto frame = frames_[channel].data();
+        FloatVectorOperations::multiply(
+            frame,
+            interleaved_gains_.data(),
+            num_values);
+        fft_.performRealOnlyInverseTransform(frame);
+        FloatVectorOperations::multiply(
+            frame,
+            synthesis_window_.data(),
+            fft_size);
+
+        auto output = output_fifos_[channel].data();
+        auto first_part = fft_size - fifo_position_;
+        FloatVectorOperations::add(output + fifo_position_, frame, first_part);
+        FloatVectorOperations::add(output, frame + first_part, fifo_position_);
+    }
+}
+
+void SpectralDynamicsProcessor::computeGains()
+{
+    // Every bin's gain computer and smoother, a register of bins at a time.
+    // The smoothing runs once per frame, so its times are set in frames.
+    auto lanes_per_register = (int) Register::SIMDNumElements;
+    auto lanes = control_;
+    for (auto i = 0; i < num_registers_; i++, lanes += lanes_per_register)
+    {
+        auto& kernel = kernels_[i];
+        auto gain_in_db = kernel.gain_computer.process(
+            Register::fromRawArray(lanes));
+        kernel.gain_smoother.process(gain_in_db).copyToRawArray(lanes);
+    }
+}
+
+void SpectralDynamicsProcessor::updateBinSettings()
+{
+    // Work out which band every bin belongs to. Bins move between bands
+    // when the crossover frequencies change, and then every bin needs its
+    // settings again.
+    auto have_bands_moved = false;
+    for (auto i = 0; i < crossovers_.size(); i++)
+    {
+        auto cutoff_in_hz = crossovers_[i]->cutoff_frequency_in_hz_->get();
+        if (cutoff_in_hz != band_cutoffs_in_hz_[(size_t) i])
+        {
+            band_cutoffs_in_hz_[(size_t) i] = cutoff_in_hz;
+            have_bands_moved = true;
+        }
+    }
+    if (have_bands_moved)
+    {
+        for (auto bin = 0; bin < num_bins; bin++)
+        {
+            auto frequency_in_hz = (float) (bin * sample_rate_in_hz_ / fft_size);
+            auto band = 0;
+            for (auto cutoff_in_hz : band_cutoffs_in_hz_)
+                if (frequency_in_hz >= cutoff_in_hz)
+                    band++;
+            bin_bands_[(size_t) bin] = band;
+        }
+    }
+
+    // A band is heard unless it's muted, or some other band is soloed and
+    // it isn't. It's compressed if it's heard, not bypassed, and not a
+    // dynamic EQ, whose filter has already shaped it.
+    auto is_any_band_soloed = false;
+    for (auto compressor : compressors_)
+        is_any_band_soloed = is_any_band_soloed || compressor->solo_->get();
+
+    for (auto band = 0; band < compressors_.size(); band++)
+    {
+        auto compressor = compressors_[band];
+
+        if (compressor->mute_->get()
+            || (is_any_band_soloed && ! compressor->solo_->get()))
+            band_states_[(size_t) band] = BandState::silent;
+        else if (compressor->bypass_->get()
+                 || compressor->getBandType()
+                        == CompressorProcessor::BandType::dynamic_eq)
+            band_states_[(size_t) band] = BandState::bypassed;
+        else
+            band_states_[(size_t) band] = BandState::compressed;
+
+        band_makeup_gains_in_db_[(size_t) band] =
+            compressor->makeup_gain_in_db_->get();
+
+        // Setting a bin's smoothing times costs a few exps, so we only
+        // touch a band's bins when its settings have actually changed.
+        BandSettings settings;
+        settings.threshold_in_db = compressor->threshold_in_db_->get();
+        settings.ratio = compressor->ratio_->get();
+        settings.knee_in_db = compressor->knee_in_db_->get();
+        settings.lower_mode = compressor->lower_mode_->getIndex();
+        settings.lower_threshold_in_db = compressor->lower_threshold_in_db_->get();
+        settings.lower_ratio = compressor->lower_ratio_->get();
+        settings.lower_range_in_db = compressor->lower_range_in_db_->get();
+        // Our times are stored in milliseconds
+        settings.attack_in_seconds = compressor->attack_in_seconds_->get() * 0.001f;
+        settings.release_in_seconds = compressor->release_in_seconds_->get() * 0.001f;
+        settings.auto_release = compressor->auto_release_->get();
+
+        if (! have_bands_moved && settings == band_settings_[(size_t) band])
+            continue;
+
+        band_settings_[(size_t) band] = settings;
+        for (auto bin = 0; bin < num_bins; bin++)
+            if (bin_bands_[(size_t) bin] == band)
+                setBinSettings(bin, settings);
+    }
+}
+
+void SpectralDynamicsProcessor::setBinSettings(
+    int bin,
+    const BandSettings& settings)
+{
+    auto lanes_per_register = (int) Register::SIMDNumElements;
+    auto& kernel = kernels_[bin / lanes_per_register];
+    auto lane = (size_t) (bin % lanes_per_register);
+
+    kernel.gain_computer.setParameters(
+        lane,
+        settings.threshold_in_db,
+        settings.ratio,
+        settings.knee_in_db);
+    kernel.gain_computer.setLowerParameters(
+        lane,
+        (GainComputer<Register>::LowerMode) settings.lower_mode,
+        settings.lower_threshold_in_db,
+        settings.lower_ratio,
+        settings.lower_range_in_db);
+    // We smooth once per frame, so the smoother's rate is our frame rate
+    kernel.gain_smoother.setTimes(
+        lane,
+        (float) (sample_rate_in_hz_ / hop_size),
+        settings.attack_in_seconds,
+        settings.release_in_seconds,
+        settings.auto_release);
+}
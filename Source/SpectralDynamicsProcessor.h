@@ -0,0 +1,154 @@
+/*
+  ==============================================================================
+
+    SpectralDynamicsProcessor.h
+    Created: 19 Oct 2026 1:49:46pm
+    Author:  Ben Hayes
+    Description:
+
+    An alternative to the crossover and compressor bank chain that
+    compresses every FFT bin separately, for much finer frequency
+    resolution than a handful of IIR bands.
+
+    The input is processed by short-time Fourier transform: overlapping
+    frames of fft_size samples, a quarter of a frame apart, are windowed,
+    transformed with a real-only FFT, given a gain per bin, transformed back
+    and overlap-added. Analysis and synthesis both use a square root Hann
+    window, so each frame fades in and out smoothly on the way back too.
+
+    Every bin belongs to whichever band its frequency falls in, as divided
+    up by the crossover frequencies, and is compressed with that band's
+    parameters: its level is run through the same GainComputer and
+    GainSmoother as the compressor bank uses, one bin per SIMD lane, with
+    the smoothing running once per frame rather than once per sample. So
+    each band's settings become a smoothed gain curve across its bins.
+
+    All our buffers are sized by fft_size, so they are allocated once in
+    prepareToPlay. The latency is one whole frame, which we report to the
+    host.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "ProcessorBase.h"
+#include "CompressorProcessor.h"
+#include "CrossoverFilterProcessor.h"
+#include "DecibelTables.h"
+#include "GainComputer.h"
+#include "GainSmoother.h"
+#include "LaneOps.h"
+#include <vector>
+
+class SpectralDynamicsProcessor : public ProcessorBase
+{
+public:
+    using Register = dsp::SIMDRegister<float>;
+
+    // 2048 samples gives bins about 21Hz apart at 44.1kHz
+    static constexpr int fft_order = 11;
+    static constexpr int fft_size = 1 << fft_order;
+    static constexpr int hop_size = fft_size / 4;
+    static constexpr int num_bins = fft_size / 2 + 1;
+
+    SpectralDynamicsProcessor(
+        const Array<CompressorProcessor*>& compressors,
+        const Array<CrossoverFilterProcessor*>& crossovers);
+    ~SpectralDynamicsProcessor();
+
+    void prepareToPlay(double sampleRate, int samplesPerBlock) override;
+    void releaseResources() override;
+    void processBlock (
+        AudioBuffer<float>& buffer,
+        MidiBuffer& midiMessages) override;
+    void processBlock (
+        AudioBuffer<double>& buffer,
+        MidiBuffer& midiMessages) override;
+    bool supportsDoublePrecisionProcessing() const override { return true; }
+    const String getName() const override { return "Spectral Dynamics"; }
+    void reset() override;
+
+private:
+    // The control path for one register's worth of bins
+    struct Kernel
+    {
+        GainComputer<Register> gain_computer;
+        GainSmoother<Register> gain_smoother;
+    };
+
+    // Everything that sets a band's gain curve, so we can tell when it
+    // changes
+    struct BandSettings
+    {
+        float threshold_in_db = 0.0f;
+        float ratio = 0.0f;
+        float knee_in_db = 0.0f;
+        int lower_mode = -1;
+        float lower_threshold_in_db = 0.0f;
+        float lower_ratio = 0.0f;
+        float lower_range_in_db = 0.0f;
+        float attack_in_seconds = 0.0f;
+        float release_in_seconds = 0.0f;
+        bool auto_release = false;
+
+        bool operator== (const BandSettings& other) const noexcept;
+    };
+
+    enum class BandState
+    {
+        silent,
+        bypassed,
+        compressed
+    };
+
+    template <typename FloatType>
+    void process(AudioBuffer<FloatType>& buffer);
+    void processFrame();
+    void updateBinSettings();
+    void setBinSettings(int bin, const BandSettings& settings);
+    void computeGains();
+
+    Array<CompressorProcessor*> compressors_;
+    Array<CrossoverFilterProcessor*> crossovers_;
+    double sample_rate_in_hz_ = 44100.0;
+
+    dsp::FFT fft_ {fft_order};
+    std::vector<float> analysis_window_;
+    // Includes the scaling that makes overlapping frames add up to unity
+    std::vector<float> synthesis_window_;
+    // Scales a bin's magnitude to the peak level of the sine that made it
+    float level_scale_ = 1.0f;
+
+    // Circular buffers of the last fft_size input samples, and of the
+    // output we're still overlap-adding, for each channel
+    std::vector<float> input_fifos_[2];
+    std::vector<float> output_fifos_[2];
+    int fifo_position_ = 0;
+    int hop_position_ = 0;
+    // How many of those channels the host is actually giving us. Only those
+    // are transformed, and the bin levels are averaged over them.
+    int num_input_channels_ = 2;
+
+    // One frame per channel, in the FFT's interleaved complex layout
+    std::vector<float> frames_[2];
+    std::vector<float> power_;
+    std::vector<float> interleaved_gains_;
+
+    // Per bin levels, then gains, padded to whole registers
+    int num_registers_ = 0;
+    HeapBlock<char> kernel_memory_;
+    Kernel* kernels_ = nullptr;
+    HeapBlock<char> control_memory_;
+    float* control_ = nullptr;
+
+    std::vector<int> bin_bands_;
+    std::vector<float> band_cutoffs_in_hz_;
+    std::vector<BandSettings> band_settings_;
+    std::vector<float> band_makeup_gains_in_db_;
+    std::vector<BandState> band_states_;
+
+    SharedResourcePointer<DecibelTables> decibel_tables_;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SpectralDynamicsProcessor)
+};
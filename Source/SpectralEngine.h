@@ -0,0 +1,70 @@
+/*
+  ==============================================================================
+
+    SpectralEngine.h
+    Created: 19 Oct 2026 2:02:40pm
+    Author:  Ben Hayes
+    Description:
+
+    The spectral dynamics processor as a MultibandEngine, so the plugin can
+    swap between it and the band splitting engine.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "MultibandEngine.h"
+#include "SpectralDynamicsProcessor.h"
+
+class SpectralEngine : public MultibandEngine
+{
+public:
+    SpectralEngine(
+        const Array<CompressorProcessor*>& compressors,
+        const Array<CrossoverFilterProcessor*>& crossovers)
+        : processor_ (compressors, crossovers)
+    {
+    }
+
+    void prepare(
+        double sample_rate_in_hz,
+        int max_block_size,
+        bool use_double_precision) override
+    {
+        // The processor works in float internally whatever the precision
+        processor_.setPlayConfigDetails(2, 2, sample_rate_in_hz, max_block_size);
+        processor_.prepareToPlay(sample_rate_in_hz, max_block_size);
+    }
+
+    void reset() override { processor_.reset(); }
+
+    void process(AudioBuffer<float>& buffer) override
+    {
+        processor_.processBlock(buffer, midi_messages_);
+    }
+
+    void process(AudioBuffer<double>& buffer) override
+    {
+        processor_.processBlock(buffer, midi_messages_);
+    }
+
+    int getLatencySamples() const override
+    {
+        return processor_.getLatencySamples();
+    }
+
+   #if MBC_ENABLE_INSTRUMENTATION
+    void setPerformanceStages(const PerformanceStages& stages) override
+    {
+        processor_.setPerformanceMonitor(stages.monitor, stages.spectral);
+    }
+   #endif
+
+private:
+    SpectralDynamicsProcessor processor_;
+    // Always empty, but processBlock needs one
+    MidiBuffer midi_messages_;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SpectralEngine)
+};
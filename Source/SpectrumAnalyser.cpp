@@ -0,0 +1,401 @@
+/*
+  ==============================================================================
+
+    SpectrumAnalyser.cpp
+    Created: 19 Oct 2026 2:04:39pm
+    Author:  Ben Hayes
+
+  ==============================================================================
+*/
+
+#include "SpectrumAnalyser.h"
+
+constexpr int SpectrumAnalyser::fft_order;
+constexpr int SpectrumAnalyser::fft_size;
+constexpr int SpectrumAnalyser::frame_rate_in_hz;
+constexpr float SpectrumAnalyser::min_level_in_db;
+constexpr float SpectrumAnalyser::max_level_in_db;
+constexpr float SpectrumAnalyser::min_frequency_in_hz;
+constexpr float SpectrumAnalyser::max_frequency_in_hz;
+constexpr float SpectrumAnalyser::fall_coefficient;
+constexpr float SpectrumAnalyser::min_visible_change_in_db;
+constexpr int SpectrumAnalyser::max_frames_to_wait_for_paint;
+
+static const Colour background_colour (0xff101418);
+
+SpectrumAnalyser::SpectrumAnalyser(
+    AnalyserTap& tap,
+    const Array<CrossoverFilterProcessor*>& crossovers)
+    : tap_ (tap),
+      crossovers_ (crossovers),
+      window_ ((size_t) fft_size),
+      history_ ((size_t) fft_size, 0.0f),
+      fft_buffer_ (2 * (size_t) fft_size),
+      bin_levels_in_db_ ((size_t) fft_size / 2 + 1, min_level_in_db),
+      band_levels_in_db_ ((size_t) crossovers.size() + 1, min_level_in_db)
+{
+    setInterceptsMouseClicks(false, false);
+    // We always fill our whole area, so nothing behind us needs repainting
+    // when we do
+    setOpaque(true);
+
+    // A Hann window keeps the leakage from loud bins well below our floor
+    dsp::WindowingFunction<float>::fillWindowingTables(
+        window_.data(),
+        (size_t) fft_size,
+        dsp::WindowingFunction<float>::hann,
+        false);
+    for (auto w : window_)
+    {
+        window_sum_ += w;
+        window_power_sum_ += w * w;
+    }
+
+    for (auto crossover : crossovers_)
+        crossover_frequencies_in_hz_.add(crossover->cutoff_frequency_in_hz_->get());
+}
+
+SpectrumAnalyser::~SpectrumAnalyser()
+{
+    stopTimer();
+    if (is_listening_)
+        tap_.setActive(false);
+}
+
+void SpectrumAnalyser::visibilityChanged()
+{
+    updateListening();
+}
+
+void SpectrumAnalyser::parentHierarchyChanged()
+{
+    updateListening();
+}
+
+void SpectrumAnalyser::updateListening()
+{
+    // Only while we're on screen does the audio thread copy samples for
+    // us, and do we spend any time analysing them
+    auto should_listen = isShowing();
+    if (should_listen == is_listening_)
+        return;
+
+    is_listening_ = should_listen;
+    tap_.setActive(should_listen);
+    if (should_listen)
+    {
+        startTimerHz(frame_rate_in_hz);
+    }
+    else
+    {
+        stopTimer();
+        frames_waiting_for_paint_ = 0;
+    }
+}
+
+void SpectrumAnalyser::resized()
+{
+    is_background_stale_ = true;
+    updateSpectrumPath();
+    levels_region_ = getLevelsRegion();
+}
+
+void SpectrumAnalyser::timerCallback()
+{
+   #if MBC_ENABLE_INSTRUMENTATION
+    auto start_ticks = Time::getHighResolutionTicks();
+   #endif
+
+    auto sample_rate_in_hz = tap_.getSampleRate();
+
+    // We always empty the FIFO, so the audio thread never has to drop
+    // samples, even on frames we skip.
+    auto got_samples = pullSamples();
+
+    // A repaint can be dropped without paint() ever being called, for
+    // instance while our window is covered, so we don't wait for one
+    // forever.
+    if (frames_waiting_for_paint_ > 0
+        && ++frames_waiting_for_paint_ > max_frames_to_wait_for_paint)
+        frames_waiting_for_paint_ = 0;
+
+    if (haveCrossoversMoved())
+    {
+        is_background_stale_ = true;
+        repaint();
+        frames_waiting_for_paint_ = 1;
+    }
+
+    // If the last frame still hasn't been painted, the screen or the
+    // message thread is running slower than us, and there's no point in
+    // working out another one.
+    if (frames_waiting_for_paint_ == 0
+        && got_samples
+        && sample_rate_in_hz > 0.0
+        && analyse(sample_rate_in_hz))
+    {
+        // Everything above both the old and new levels is just background
+        // that hasn't changed, so we only repaint below the higher of the
+        // two.
+        updateSpectrumPath();
+        auto levels_region = getLevelsRegion();
+        auto dirty_region = levels_region.getUnion(levels_region_);
+        levels_region_ = levels_region;
+        // An empty region is never painted, so there's nothing to wait for
+        if (! dirty_region.isEmpty())
+        {
+            repaint(dirty_region);
+            frames_waiting_for_paint_ = 1;
+        }
+    }
+
+   #if MBC_ENABLE_INSTRUMENTATION
+    frame_ticks_ += Time::getHighResolutionTicks() - start_ticks;
+   #endif
+}
+
+bool SpectrumAnalyser::pullSamples()
+{
+    // We read straight into our circular history buffer, a contiguous run
+    // at a time, until the FIFO is empty. If more than fft_size samples
+    // were waiting, we simply end up with the newest of them.
+    auto got_samples = false;
+    for (;;)
+    {
+        auto num_samples = tap_.pull(
+            history_.data() + history_position_,
+            fft_size - history_position_);
+        if (num_samples == 0)
+            break;
+        history_position_ = (history_position_ + num_samples) % fft_size;
+        got_samples = true;
+    }
+    return got_samples;
+}
+
+bool SpectrumAnalyser::haveCrossoversMoved()
+{
+    auto have_moved = false;
+    for (auto i = 0; i < crossovers_.size(); i++)
+    {
+        auto frequency_in_hz = crossovers_[i]->cutoff_frequency_in_hz_->get();
+        if (frequency_in_hz != crossover_frequencies_in_hz_[i])
+        {
+            crossover_frequencies_in_hz_.set(i, frequency_in_hz);
+            have_moved = true;
+        }
+    }
+    return have_moved;
+}
+
+bool SpectrumAnalyser::analyse(double sample_rate_in_hz)
+{
+    sample_rate_in_hz_ = sample_rate_in_hz;
+    auto largest_change_in_db = 0.0f;
+    auto smooth = [&largest_change_in_db] (float& smoothed, float level_in_db)
+    {
+        auto previous = smoothed;
+        smoothed = level_in_db > smoothed
+            ? level_in_db
+            : smoothed + fall_coefficient * (level_in_db - smoothed);
+        largest_change_in_db = jmax(
+            largest_change_in_db,
+            std::abs(smoothed - previous));
+    };
+
+    // Unroll our history, oldest sample first, and window it:
+    auto num_oldest = fft_size - history_position_;
+    FloatVectorOperations::multiply(
+        fft_buffer_.data(),
+        history_.data() + history_position_,
+        window_.data(),
+        num_oldest);
+    FloatVectorOperations::multiply(
+        fft_buffer_.data() + num_oldest,
+        history_.data(),
+        window_.data() + num_oldest,
+        history_position_);
+    fft_.performFrequencyOnlyForwardTransform(fft_buffer_.data());
+
+    // A full scale sine lands in its bin with a magnitude of half the
+    // window's sum, so we scale each bin to read 0dB for one.
+    auto num_bins = fft_size / 2 + 1;
+    auto bin_scale = 2.0f / window_sum_;
+    for (auto bin = 0; bin < num_bins; bin++)
+        smooth(
+            bin_levels_in_db_[(size_t) bin],
+            Decibels::gainToDecibels(
+                fft_buffer_[(size_t) bin] * bin_scale,
+                min_level_in_db));
+
+    // Each band's level is the power of all of its bins, scaled so that
+    // it reads as the band's RMS level against a full scale sine.
+    auto hz_per_bin = (float) sample_rate_in_hz / (float) fft_size;
+    auto power_scale = 4.0f / ((float) fft_size * window_power_sum_);
+    auto bin = 1;
+    for (auto band = 0; band < (int) band_levels_in_db_.size(); band++)
+    {
+        auto upper_bin = num_bins;
+        if (band < crossover_frequencies_in_hz_.size())
+            upper_bin = jmin(
+                num_bins,
+                roundToInt(crossover_frequencies_in_hz_[band] / hz_per_bin));
+
+        auto power = 0.0f;
+        for (; bin < upper_bin; bin++)
+            power += fft_buffer_[(size_t) bin] * fft_buffer_[(size_t) bin];
+
+        smooth(
+            band_levels_in_db_[(size_t) band],
+            Decibels::gainToDecibels(
+                std::sqrt(power * power_scale),
+                min_level_in_db));
+    }
+
+    return largest_change_in_db >= min_visible_change_in_db;
+}
+
+void SpectrumAnalyser::updateSpectrumPath()
+{
+    // We interpolate between bins, since at the top end there are many
+    // bins to a pixel and at the bottom there are many pixels to a bin.
+    spectrum_path_.clear();
+    if (sample_rate_in_hz_ <= 0.0 || getWidth() <= 0)
+        return;
+
+    auto width = (float) getWidth();
+    auto bins_per_hz = (float) fft_size / (float) sample_rate_in_hz_;
+    auto last_bin = (float) (bin_levels_in_db_.size() - 1);
+    spectrum_path_.preallocateSpace(3 * (getWidth() / 2 + 2));
+    for (auto x = 0.0f; x <= width; x += 2.0f)
+    {
+        auto frequency_in_hz = min_frequency_in_hz * std::pow(
+            max_frequency_in_hz / min_frequency_in_hz,
+            x / width);
+        auto bin = jmin(last_bin, frequency_in_hz * bins_per_hz);
+        auto lower_bin = (int) bin;
+        auto upper_bin = jmin((int) last_bin, lower_bin + 1);
+        auto fraction = bin - (float) lower_bin;
+        auto level_in_db = bin_levels_in_db_[(size_t) lower_bin]
+            + fraction * (bin_levels_in_db_[(size_t) upper_bin]
+                - bin_levels_in_db_[(size_t) lower_bin]);
+
+        if (x == 0.0f)
+            spectrum_path_.startNewSubPath(x, yForLevel(level_in_db));
+        else
+            spectrum_path_.lineTo(x, yForLevel(level_in_db));
+    }
+}
+
+Rectangle<int> SpectrumAnalyser::getLevelsRegion() const
+{
+    // Everything we draw on top of the background, from the highest point
+    // of the spectrum or the band levels down to the bottom, allowing for
+    // the width of the spectrum's line
+    auto top = (float) getHeight();
+    if (! spectrum_path_.isEmpty())
+        top = spectrum_path_.getBounds().getY();
+    for (auto level_in_db : band_levels_in_db_)
+        top = jmin(top, yForLevel(level_in_db));
+
+    auto top_pixel = jmax(0, (int) std::floor(top) - 2);
+    return getLocalBounds().withTop(top_pixel);
+}
+
+float SpectrumAnalyser::xForFrequency(float frequency_in_hz) const
+{
+    auto proportion = std::log(frequency_in_hz / min_frequency_in_hz)
+        / std::log(max_frequency_in_hz / min_frequency_in_hz);
+    return proportion * (float) getWidth();
+}
+
+float SpectrumAnalyser::yForLevel(float level_in_db) const
+{
+    return jmap(
+        jlimit(min_level_in_db, max_level_in_db, level_in_db),
+        min_level_in_db,
+        max_level_in_db,
+        (float) getHeight(),
+        0.0f);
+}
+
+void SpectrumAnalyser::renderBackground()
+{
+    background_ = Image(Image::RGB, jmax(1, getWidth()), jmax(1, getHeight()), false);
+    Graphics g (background_);
+    g.fillAll(background_colour);
+
+    auto width = (float) getWidth();
+    auto height = (float) getHeight();
+
+    // A faint grid every 20dB, and at 1, 2 and 5 times every decade
+    g.setColour(Colours::white.withAlpha(0.08f));
+    for (auto level_in_db = max_level_in_db - 20.0f;
+         level_in_db > min_level_in_db;
+         level_in_db -= 20.0f)
+        g.drawHorizontalLine(roundToInt(yForLevel(level_in_db)), 0.0f, width);
+    for (auto decade = 10.0f; decade < max_frequency_in_hz; decade *= 10.0f)
+        for (auto multiple : {1.0f, 2.0f, 5.0f})
+        {
+            auto frequency_in_hz = decade * multiple;
+            if (frequency_in_hz > min_frequency_in_hz
+                && frequency_in_hz < max_frequency_in_hz)
+                g.drawVerticalLine(
+                    roundToInt(xForFrequency(frequency_in_hz)),
+                    0.0f,
+                    height);
+        }
+
+    // And the crossovers themselves
+    g.setColour(Colours::orange);
+    for (auto frequency_in_hz : crossover_frequencies_in_hz_)
+        g.drawVerticalLine(
+            roundToInt(xForFrequency(frequency_in_hz)),
+            0.0f,
+            height);
+
+    is_background_stale_ = false;
+}
+
+void SpectrumAnalyser::paint(Graphics& g)
+{
+   #if MBC_ENABLE_INSTRUMENTATION
+    auto start_ticks = Time::getHighResolutionTicks();
+   #endif
+
+    frames_waiting_for_paint_ = 0;
+
+    if (is_background_stale_)
+        renderBackground();
+    g.drawImageAt(background_, 0, 0);
+
+    if (sample_rate_in_hz_ > 0.0)
+    {
+        // Each band's level as a block behind the spectrum, between the
+        // crossovers either side of it
+        auto height = (float) getHeight();
+        auto band_start = 0.0f;
+        g.setColour(Colours::steelblue.withAlpha(0.35f));
+        for (auto band = 0; band < (int) band_levels_in_db_.size(); band++)
+        {
+            auto band_end = band < crossover_frequencies_in_hz_.size()
+                ? xForFrequency(crossover_frequencies_in_hz_[band])
+                : (float) getWidth();
+            auto top = yForLevel(band_levels_in_db_[(size_t) band]);
+            g.fillRect(band_start, top, band_end - band_start, height - top);
+            band_start = band_end;
+        }
+
+        g.setColour(Colours::white);
+        g.strokePath(spectrum_path_, PathStrokeType(1.0f));
+    }
+
+   #if MBC_ENABLE_INSTRUMENTATION
+    // A frame's cost is whatever we spent in the timer working it out, plus
+    // painting it
+    if (performance_monitor_ != nullptr)
+        performance_monitor_->recordEditorFrame(
+            frame_ticks_ + Time::getHighResolutionTicks() - start_ticks);
+    frame_ticks_ = 0;
+   #endif
+}
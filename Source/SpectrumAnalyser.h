@@ -0,0 +1,132 @@
+/*
+  ==============================================================================
+
+    SpectrumAnalyser.h
+    Created: 19 Oct 2026 2:04:39pm
+    Author:  Ben Hayes
+    Description:
+
+    Shows the spectrum of the plugin's input on a logarithmic frequency
+    axis, with the crossover frequencies marked and each band's level
+    drawn behind it, so you can see where the crossovers fall relative to
+    the material.
+
+    Everything here runs on the message thread. Each frame we pull
+    whatever the audio thread has left in our AnalyserTap into a history
+    buffer, window the latest fft_size samples, and take one FFT. The
+    levels rise straight away and fall back smoothly, like a meter.
+
+    Since there may be many editors open at once, drawing is kept as cheap
+    as we can make it:
+      - The grid and crossover lines are drawn once into a cached image,
+        and only redrawn when the size or a crossover changes.
+      - Each frame only repaints the region the spectrum and band levels
+        covered last frame or cover now, and nothing at all once the levels
+        have settled.
+      - We never get more than one frame ahead of the screen: while a
+        repaint we've asked for hasn't been painted yet, we keep draining
+        the FIFO but skip the analysis. On a busy message thread that
+        drops our frame rate rather than queuing up work. A repaint that
+        never arrives (say our window is covered) only holds us up for a
+        few frames.
+      - The analyser stops listening, and the audio thread stops copying
+        samples, whenever it isn't showing.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "AnalyserTap.h"
+#include "CrossoverFilterProcessor.h"
+#include "PerformanceMonitor.h"
+#include <vector>
+
+class SpectrumAnalyser : public Component,
+                         private Timer
+{
+public:
+    static constexpr int fft_order = 11;
+    static constexpr int fft_size = 1 << fft_order;
+    static constexpr int frame_rate_in_hz = 30;
+    static constexpr float min_level_in_db = -90.0f;
+    static constexpr float max_level_in_db = 0.0f;
+    static constexpr float min_frequency_in_hz = 20.0f;
+    static constexpr float max_frequency_in_hz = 20000.0f;
+    // How much of the way back down to a lower level we fall each frame
+    static constexpr float fall_coefficient = 0.2f;
+    // Changes smaller than this aren't worth a repaint
+    static constexpr float min_visible_change_in_db = 0.1f;
+    // How many frames we wait for a repaint we've asked for before giving
+    // up on it, since the OS is free to drop one
+    static constexpr int max_frames_to_wait_for_paint = 3;
+
+    SpectrumAnalyser(
+        AnalyserTap& tap,
+        const Array<CrossoverFilterProcessor*>& crossovers);
+    ~SpectrumAnalyser();
+
+    void paint(Graphics& g) override;
+    void resized() override;
+    void visibilityChanged() override;
+    void parentHierarchyChanged() override;
+
+   #if MBC_ENABLE_INSTRUMENTATION
+    // Records how long each frame takes into the monitor's editor frame
+    // histogram
+    void setPerformanceMonitor(PerformanceMonitor* monitor) { performance_monitor_ = monitor; }
+   #endif
+
+private:
+    void timerCallback() override;
+    void updateListening();
+    bool pullSamples();
+    bool haveCrossoversMoved();
+    bool analyse(double sample_rate_in_hz);
+    void updateSpectrumPath();
+    Rectangle<int> getLevelsRegion() const;
+    void renderBackground();
+    float xForFrequency(float frequency_in_hz) const;
+    float yForLevel(float level_in_db) const;
+
+    AnalyserTap& tap_;
+    Array<CrossoverFilterProcessor*> crossovers_;
+
+    dsp::FFT fft_ {fft_order};
+    std::vector<float> window_;
+    float window_sum_ = 0.0f;
+    float window_power_sum_ = 0.0f;
+
+    // The latest fft_size samples, as a circular buffer
+    std::vector<float> history_;
+    int history_position_ = 0;
+    std::vector<float> fft_buffer_;
+
+    // The smoothed level of every bin, and of every band, in dB
+    std::vector<float> bin_levels_in_db_;
+    std::vector<float> band_levels_in_db_;
+    double sample_rate_in_hz_ = 0.0;
+
+    // What we draw, worked out in the timer so that paint only draws it
+    Path spectrum_path_;
+    Array<float> crossover_frequencies_in_hz_;
+    Rectangle<int> levels_region_;
+
+    // The grid and crossovers, redrawn only when they change
+    Image background_;
+    bool is_background_stale_ = true;
+
+    bool is_listening_ = false;
+    // How many frames we've been waiting for our last repaint to be
+    // painted, or 0 if we aren't
+    int frames_waiting_for_paint_ = 0;
+
+   #if MBC_ENABLE_INSTRUMENTATION
+    PerformanceMonitor* performance_monitor_ = nullptr;
+    // Time spent in the timer since the last paint
+    int64 frame_ticks_ = 0;
+   #endif
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SpectrumAnalyser)
+};
@@ -0,0 +1,110 @@
+/*
+  ==============================================================================
+
+    StateVariableFilter.h
+    Created: 19 Oct 2026 1:30:43pm
+    Author:  Ben Hayes
+    Description:
+
+    A 2nd order state variable filter discretised with the topology
+    preserving transform (TPT), following Zavalishin's "The Art of VA
+    Filter Design" and Andy Simper's trapezoidal SVF.
+
+    A direct form biquad stores its poles as a1 = -2r.cos(theta) and
+    a2 = r^2, which for a 40Hz cutoff at 192kHz are within a few parts in
+    ten thousand of -2 and 1. In float, most of the coefficient's precision
+    then goes on representing those values rather than the pole position,
+    so the response and noise floor suffer. The TPT structure is instead
+    parameterised by g = tan(pi.fc/fs), which float represents with full
+    relative precision however small it gets, and its state variables are
+    integrator outputs that stay on the scale of the signal. This lets us
+    keep processing in single precision at extreme cutoff/sample rate
+    ratios.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+
+template <typename FloatType>
+class StateVariableFilter
+{
+public:
+    StateVariableFilter()
+    {
+        setCutoff(44100.0, 20000.0);
+    }
+
+    // k = 1/Q, the amount of band pass fed back around the loop. The
+    // allpass response with the same poles is input - 2k.band_pass.
+    FloatType getDamping() const noexcept { return k_; }
+
+    // Coefficients are always calculated in double precision, then rounded
+    // once to our sample type. The default Q of 1/sqrt(2) gives a
+    // Butterworth response, two of which in series make a Linkwitz-Riley
+    // filter.
+    void setCutoff(
+        double sample_rate_in_hz,
+        double cutoff_in_hz,
+        double q = MathConstants<double>::sqrt2 * 0.5) noexcept
+    {
+        auto g = std::tan(
+            MathConstants<double>::pi
+            * jmin(cutoff_in_hz, sample_rate_in_hz * 0.49)
+            / sample_rate_in_hz);
+        auto k = 1.0 / q;
+        auto a1 = 1.0 / (1.0 + g * (g + k));
+
+        k_ = (FloatType) k;
+        a1_ = (FloatType) a1;
+        a2_ = (FloatType) (g * a1);
+        a3_ = (FloatType) (g * g * a1);
+    }
+
+    void prepare(int num_channels)
+    {
+        ic1_.assign((size_t) num_channels, FloatType());
+        ic2_.assign((size_t) num_channels, FloatType());
+    }
+
+    void reset() noexcept
+    {
+        std::fill(ic1_.begin(), ic1_.end(), FloatType());
+        std::fill(ic2_.begin(), ic2_.end(), FloatType());
+    }
+
+    // Runs one sample through the filter, giving the low, band and high pass
+    // outputs at once. They all share the same two integrator states.
+    void processSample(
+        int channel,
+        FloatType input,
+        FloatType& low_pass,
+        FloatType& band_pass,
+        FloatType& high_pass) noexcept
+    {
+        auto& ic1 = ic1_[(size_t) channel];
+        auto& ic2 = ic2_[(size_t) channel];
+
+        auto v3 = input - ic2;
+        auto v1 = a1_ * ic1 + a2_ * v3;
+        auto v2 = ic2 + a2_ * ic1 + a3_ * v3;
+        ic1 = (FloatType) 2 * v1 - ic1;
+        ic2 = (FloatType) 2 * v2 - ic2;
+
+        low_pass = v2;
+        band_pass = v1;
+        high_pass = input - k_ * v1 - v2;
+    }
+
+private:
+    FloatType k_;
+    FloatType a1_;
+    FloatType a2_;
+    FloatType a3_;
+
+    std::vector<FloatType> ic1_;
+    std::vector<FloatType> ic2_;
+};
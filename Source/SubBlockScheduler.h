@@ -0,0 +1,68 @@
+/*
+  ==============================================================================
+
+    SubBlockScheduler.h
+    Created: 19 Oct 2026 1:28:35pm
+    Author:  Ben Hayes
+    Description:
+
+    Splits whatever size of buffer the host gives us into fixed size
+    sub-blocks, counting across calls, so that control rate work (updating
+    filter coefficients, timing constants etc.) happens every sub_block_size
+    samples no matter how big the host's buffers are.
+
+    Large host buffers get split at every sub-block boundary. Small host
+    buffers are passed through in one piece, but only the ones that start a
+    new sub-block are flagged for a control update, so the cost of that
+    update is shared between several host buffers.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class SubBlockScheduler
+{
+public:
+    // 64 samples of stereo float comfortably fits every band of the
+    // multiband process in L1 cache.
+    static constexpr int default_sub_block_size = 64;
+
+    SubBlockScheduler(int sub_block_size = default_sub_block_size)
+        : sub_block_size_ (sub_block_size)
+    {
+        jassert(sub_block_size > 0);
+    }
+
+    void reset() noexcept { position_in_sub_block_ = 0; }
+    int getSubBlockSize() const noexcept { return sub_block_size_; }
+
+    // Calls process_sub_block(start_sample, num_samples, is_new_sub_block)
+    // for each piece of the num_samples long block. No piece ever crosses a
+    // sub-block boundary.
+    template <typename Function>
+    void process(int num_samples, Function&& process_sub_block)
+    {
+        auto start_sample = 0;
+        while (start_sample < num_samples)
+        {
+            auto is_new_sub_block = position_in_sub_block_ == 0;
+            auto length = jmin(
+                num_samples - start_sample,
+                sub_block_size_ - position_in_sub_block_);
+
+            process_sub_block(start_sample, length, is_new_sub_block);
+
+            position_in_sub_block_ += length;
+            if (position_in_sub_block_ == sub_block_size_)
+                position_in_sub_block_ = 0;
+            start_sample += length;
+        }
+    }
+
+private:
+    int sub_block_size_;
+    int position_in_sub_block_ = 0;
+};
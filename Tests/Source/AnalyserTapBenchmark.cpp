@@ -0,0 +1,113 @@
+/*
+  ==============================================================================
+
+    AnalyserTapBenchmark.cpp
+    Created: 19 Oct 2026 2:25:59pm
+    Author:  Ben Hayes
+
+  ==============================================================================
+*/
+
+#include "TestUtilities.h"
+#include "../../Source/AnalyserTap.h"
+
+using namespace TestUtilities;
+
+class AnalyserTapBenchmark : public UnitTest
+{
+public:
+    AnalyserTapBenchmark() : UnitTest ("Analyser Tap", "Benchmarks") {}
+
+    void runTest() override
+    {
+        // Everything the audio thread does for the spectrum analyser is in
+        // AnalyserTap::push(), so that's all we need to time. We compare it
+        // with simply copying the same stereo block, which is the least any
+        // way of getting samples off the audio thread could cost.
+        AnalyserTap tap;
+        tap.prepare(sample_rate_in_hz);
+        auto input = makeProgramMaterial(block_size);
+        AudioBuffer<float> copy (2, block_size);
+        std::vector<float> pulled ((size_t) AnalyserTap::fifo_size);
+
+        auto copy_seconds = timePerBlock([&] {
+            for (auto channel = 0; channel < 2; channel++)
+                std::memcpy(
+                    copy.getWritePointer(channel),
+                    input.getReadPointer(channel),
+                    sizeof (float) * (size_t) block_size);
+        }, [] {});
+
+        beginTest("With the editor closed, the tap costs less than a copy");
+        tap.setActive(false);
+        auto inactive_seconds = timePerBlock(
+            [&] { tap.push(input); },
+            [] {});
+        expectWithinBudget(
+            *this,
+            "Closed tap per block in microseconds",
+            inactive_seconds * 1.0e6,
+            copy_seconds * 1.0e6);
+
+        beginTest("With the editor open, the tap costs about a copy");
+        tap.setActive(true);
+        auto active_seconds = timePerBlock(
+            [&] { tap.push(input); },
+            [&] { tap.pull(pulled.data(), AnalyserTap::fifo_size); });
+        expectWithinBudget(
+            *this,
+            "Open tap per block, as a multiple of a copy",
+            active_seconds / copy_seconds,
+            max_copies_per_block);
+
+        // And in absolute terms, a sliver of the time the block lasts
+        auto block_duration_in_seconds = block_size / sample_rate_in_hz;
+        expectWithinBudget(
+            *this,
+            "Open tap per block, as a percentage of realtime",
+            100.0 * active_seconds / block_duration_in_seconds,
+            max_realtime_percentage);
+    }
+
+private:
+    static constexpr int block_size = 512;
+    // Enough blocks per run to be well above the timer's resolution, while
+    // still fitting in the tap's FIFO
+    static constexpr int blocks_per_run = 16;
+    static constexpr int num_runs = 2000;
+    static constexpr int num_warm_up_runs = 100;
+    static constexpr double max_copies_per_block = 4.0;
+    static constexpr double max_realtime_percentage = 0.1;
+
+    // The median time per block that process takes, running blocks_per_run
+    // blocks at a time, with tidy_up run untimed after each run
+    template <typename Process, typename TidyUp>
+    static double timePerBlock(Process&& process, TidyUp&& tidy_up)
+    {
+        std::vector<double> timings;
+        timings.reserve((size_t) num_runs);
+        for (auto run = 0; run < num_warm_up_runs + num_runs; run++)
+        {
+            auto start_ticks = Time::getHighResolutionTicks();
+            for (auto block = 0; block < blocks_per_run; block++)
+                process();
+            auto end_ticks = Time::getHighResolutionTicks();
+            tidy_up();
+
+            if (run >= num_warm_up_runs)
+                timings.push_back(
+                    Time::highResolutionTicksToSeconds(end_ticks - start_ticks)
+                    / blocks_per_run);
+        }
+        return getMedian(timings);
+    }
+};
+
+constexpr int AnalyserTapBenchmark::block_size;
+constexpr int AnalyserTapBenchmark::blocks_per_run;
+constexpr int AnalyserTapBenchmark::num_runs;
+constexpr int AnalyserTapBenchmark::num_warm_up_runs;
+constexpr double AnalyserTapBenchmark::max_copies_per_block;
+constexpr double AnalyserTapBenchmark::max_realtime_percentage;
+
+static AnalyserTapBenchmark analyser_tap_benchmark;
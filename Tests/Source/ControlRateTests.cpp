@@ -0,0 +1,167 @@
+/*
+  ==============================================================================
+
+    ControlRateTests.cpp
+    Created: 19 Oct 2026 2:25:02pm
+    Author:  Ben Hayes
+
+  ==============================================================================
+*/
+
+#include "TestUtilities.h"
+#include "../../Source/CompressorBankProcessor.h"
+
+using namespace TestUtilities;
+
+class ControlRateTests : public UnitTest
+{
+public:
+    ControlRateTests() : UnitTest ("Control Rate Sidechain", "DSP") {}
+
+    void runTest() override
+    {
+        // Bands that share a SIMD register share the interval of the
+        // fastest attack among them, so we test each interval with a bank
+        // of its own, with one band whose attack is just slow enough for
+        // it. At 44.1kHz an interval of K needs an attack of at least
+        // 32K samples, or 0.73K ms.
+        auto input = makeProgramMaterial(num_samples);
+        for (auto& test_case : getTestCases())
+        {
+            beginTest(
+                "Control rate gain stays close to audio rate with an interval of "
+                + String(test_case.expected_interval));
+            expectCloseToAudioRate(input, test_case);
+        }
+    }
+
+private:
+    static constexpr int num_samples = 4 * 44100;
+    static constexpr int host_block_size = 512;
+    static constexpr float min_level = 1.0e-3f;
+    static constexpr double min_gain_reduction_in_db = 6.0;
+    // A little above what we claim in the README, which is about 0.4dB at
+    // worst and 0.05dB RMS
+    static constexpr double max_gain_difference_in_db = 0.5;
+    static constexpr double rms_gain_difference_in_db = 0.1;
+
+    struct TestCase
+    {
+        float attack_in_ms;
+        int expected_interval;
+    };
+
+    static std::vector<TestCase> getTestCases()
+    {
+        return {
+            {30.0f, CompressorBankProcessor::max_control_interval},
+            {8.0f, 8},
+            {4.0f, 4},
+            {2.0f, 2},
+            {1.0f, 1}};
+    }
+
+    void expectCloseToAudioRate(
+        const AudioBuffer<float>& input,
+        const TestCase& test_case)
+    {
+        int audio_rate_interval, control_rate_interval;
+        auto audio_rate_output = render(
+            input,
+            test_case.attack_in_ms,
+            false,
+            audio_rate_interval);
+        auto control_rate_output = render(
+            input,
+            test_case.attack_in_ms,
+            true,
+            control_rate_interval);
+        expectEquals(audio_rate_interval, 1);
+        expectEquals(control_rate_interval, test_case.expected_interval);
+
+        // The compressor bank only ever applies a gain, so the ratio of the
+        // two outputs is the difference between the gains they applied.
+        // We skip samples too quiet for that ratio to mean anything.
+        auto max_difference_in_db = 0.0;
+        auto sum_of_squares = 0.0;
+        auto num_compared = 0;
+        auto max_gain_reduction_in_db = 0.0;
+        for (auto channel = 0; channel < audio_rate_output.getNumChannels(); channel++)
+        {
+            auto in = input.getReadPointer(channel % 2);
+            auto audio_rate = audio_rate_output.getReadPointer(channel);
+            auto control_rate = control_rate_output.getReadPointer(channel);
+            for (auto n = 0; n < num_samples; n++)
+            {
+                if (std::abs(in[n]) < min_level)
+                    continue;
+
+                auto difference_in_db = Decibels::gainToDecibels(
+                    std::abs((double) control_rate[n] / (double) audio_rate[n]));
+                max_difference_in_db = jmax(
+                    max_difference_in_db,
+                    std::abs(difference_in_db));
+                sum_of_squares += difference_in_db * difference_in_db;
+                num_compared++;
+
+                max_gain_reduction_in_db = jmax(
+                    max_gain_reduction_in_db,
+                    -Decibels::gainToDecibels(
+                        std::abs((double) audio_rate[n] / (double) in[n])));
+            }
+        }
+
+        // Make sure we're actually compressing, or there's nothing to
+        // compare
+        expect(
+            max_gain_reduction_in_db >= min_gain_reduction_in_db,
+            "Only compressed by " + String(max_gain_reduction_in_db, 1) + "dB");
+
+        auto rms_difference_in_db = std::sqrt(sum_of_squares / jmax(1, num_compared));
+        logMessage(
+            "Control rate gain differs by " + String(max_difference_in_db, 3)
+            + "dB at worst, " + String(rms_difference_in_db, 3) + "dB RMS");
+        expect(
+            max_difference_in_db <= max_gain_difference_in_db,
+            "Worst gain difference of " + String(max_difference_in_db, 3) + "dB");
+        expect(
+            rms_difference_in_db <= rms_gain_difference_in_db,
+            "RMS gain difference of " + String(rms_difference_in_db, 3) + "dB");
+    }
+
+    // One band compressing the drum loop, with the interval its gain was
+    // computed at
+    static AudioBuffer<float> render(
+        const AudioBuffer<float>& input,
+        float attack_in_ms,
+        bool use_control_rate,
+        int& interval)
+    {
+        TestBands bands (1);
+        bands.control_rate_sidechain = use_control_rate;
+        auto compressor = bands.compressors[0];
+        *compressor->threshold_in_db_ = -30.0f;
+        *compressor->ratio_ = 4.0f;
+        *compressor->attack_in_seconds_ = attack_in_ms;
+        *compressor->release_in_seconds_ = 200.0f;
+
+        CompressorBankProcessor compressor_bank (
+            bands.compressors,
+            &bands.control_rate_sidechain);
+        compressor_bank.prepareToPlay(sample_rate_in_hz, host_block_size);
+
+        AudioBuffer<float> buffer (input);
+        processInBlocks(compressor_bank, buffer, host_block_size);
+        interval = compressor_bank.getControlInterval(0);
+        return buffer;
+    }
+};
+
+constexpr int ControlRateTests::num_samples;
+constexpr int ControlRateTests::host_block_size;
+constexpr float ControlRateTests::min_level;
+constexpr double ControlRateTests::min_gain_reduction_in_db;
+constexpr double ControlRateTests::max_gain_difference_in_db;
+constexpr double ControlRateTests::rms_gain_difference_in_db;
+
+static ControlRateTests control_rate_tests;
@@ -0,0 +1,145 @@
+/*
+  ==============================================================================
+
+    CrossoverTests.cpp
+    Created: 19 Oct 2026 2:24:30pm
+    Author:  Ben Hayes
+
+  ==============================================================================
+*/
+
+#include "TestUtilities.h"
+#include "../../Source/LinkwitzRileyCrossover.h"
+
+using namespace TestUtilities;
+
+class CrossoverTests : public UnitTest
+{
+public:
+    CrossoverTests() : UnitTest ("Linkwitz-Riley Crossover", "DSP") {}
+
+    void runTest() override
+    {
+        // The low and high outputs should add up to the LR4's allpass in
+        // both modes, including with the cutoff very low or very high for
+        // the sample rate, where the filters are least accurate.
+        for (auto mode : {Mode::filtered, Mode::complementary})
+        {
+            auto mode_name = mode == Mode::filtered ? "filtered" : "complementary";
+            beginTest(String("Float bands sum to the allpass in ") + mode_name + " mode");
+            for (auto& ratio : getCutoffRatios())
+                expectSumsToAllpass<float>(
+                    mode,
+                    ratio,
+                    float_tolerance_in_db,
+                    float_flatness_in_db);
+
+            beginTest(String("Double bands sum to the allpass in ") + mode_name + " mode");
+            for (auto& ratio : getCutoffRatios())
+                expectSumsToAllpass<double>(
+                    mode,
+                    ratio,
+                    double_tolerance_in_db,
+                    double_flatness_in_db);
+        }
+    }
+
+private:
+    using Mode = LinkwitzRileyCrossover<float>::Mode;
+
+    // Long enough for a 20Hz crossover at 192kHz to ring down by well over
+    // 120dB
+    static constexpr int fft_order = 17;
+    static constexpr double float_tolerance_in_db = -70.0;
+    static constexpr double double_tolerance_in_db = -180.0;
+    static constexpr float float_flatness_in_db = 0.01f;
+    // Our FFT is single precision, so this is as flat as it can measure
+    static constexpr float double_flatness_in_db = 1.0e-4f;
+
+    struct CutoffRatio
+    {
+        double cutoff_in_hz;
+        double sample_rate_in_hz;
+    };
+
+    static std::vector<CutoffRatio> getCutoffRatios()
+    {
+        return {
+            {20.0, 192000.0},
+            {1000.0, 48000.0},
+            {20000.0, 44100.0}};
+    }
+
+    template <typename FloatType>
+    void expectSumsToAllpass(
+        Mode mode,
+        CutoffRatio ratio,
+        double tolerance_in_db,
+        float flatness_in_db)
+    {
+        auto num_samples = 1 << fft_order;
+        auto description = String(ratio.cutoff_in_hz) + "Hz at "
+            + String(ratio.sample_rate_in_hz) + "Hz";
+
+        LinkwitzRileyCrossover<FloatType> crossover;
+        crossover.setMode(
+            mode == Mode::filtered
+                ? LinkwitzRileyCrossover<FloatType>::Mode::filtered
+                : LinkwitzRileyCrossover<FloatType>::Mode::complementary);
+        crossover.setCutoff(ratio.sample_rate_in_hz, ratio.cutoff_in_hz);
+        crossover.prepare(1);
+
+        std::vector<FloatType> input ((size_t) num_samples, FloatType());
+        std::vector<FloatType> low ((size_t) num_samples);
+        std::vector<FloatType> high ((size_t) num_samples);
+        input[0] = (FloatType) 1;
+        crossover.process(0, input.data(), low.data(), high.data(), num_samples);
+
+        // Our reference is the allpass made from a single Butterworth
+        // section with the same cutoff, input - 2k.band_pass, worked out in
+        // double precision:
+        StateVariableFilter<double> reference;
+        reference.setCutoff(ratio.sample_rate_in_hz, ratio.cutoff_in_hz);
+        reference.prepare(1);
+
+        std::vector<float> sum ((size_t) num_samples);
+        auto max_error = 0.0;
+        for (auto n = 0; n < num_samples; n++)
+        {
+            double reference_low, reference_band, reference_high;
+            reference.processSample(
+                0,
+                (double) input[(size_t) n],
+                reference_low,
+                reference_band,
+                reference_high);
+            auto allpass = (double) input[(size_t) n]
+                - 2.0 * reference.getDamping() * reference_band;
+
+            auto band_sum = (double) low[(size_t) n] + (double) high[(size_t) n];
+            max_error = jmax(max_error, std::abs(band_sum - allpass));
+            sum[(size_t) n] = (float) band_sum;
+        }
+
+        auto error_in_db = Decibels::gainToDecibels(max_error, -300.0);
+        expect(
+            error_in_db <= tolerance_in_db,
+            description + " differs from the allpass by "
+                + String(error_in_db, 1) + "dB");
+
+        // And whatever the reference says, the sum's magnitude should be
+        // flat:
+        auto deviation_in_db = getMaxDeviationFromFlatInDb(sum.data(), fft_order);
+        expect(
+            deviation_in_db <= flatness_in_db,
+            description + " strays " + String(deviation_in_db, 6) + "dB from flat");
+    }
+};
+
+constexpr int CrossoverTests::fft_order;
+constexpr double CrossoverTests::float_tolerance_in_db;
+constexpr double CrossoverTests::double_tolerance_in_db;
+constexpr float CrossoverTests::float_flatness_in_db;
+constexpr float CrossoverTests::double_flatness_in_db;
+
+static CrossoverTests crossover_tests;
@@ -0,0 +1,117 @@
+/*
+  ==============================================================================
+
+    EngineBenchmark.cpp
+    Created: 19 Oct 2026 2:26:28pm
+    Author:  Ben Hayes
+
+  ==============================================================================
+*/
+
+#include "TestUtilities.h"
+#include "../../Source/BandSplitEngine.h"
+#include "../../Source/SpectralEngine.h"
+
+using namespace TestUtilities;
+
+class EngineBenchmark : public UnitTest
+{
+public:
+    EngineBenchmark() : UnitTest ("Multiband Engines", "Benchmarks") {}
+
+    void runTest() override
+    {
+        // Both engines get the plugin's default five bands, compressing
+        // the drum loop, so that every stage of each has work to do:
+        TestBands bands (5);
+        for (auto compressor : bands.compressors)
+            *compressor->threshold_in_db_ = -30.0f;
+        auto input = makeProgramMaterial(num_samples);
+
+        beginTest("Band split engine cost per sample");
+        BandSplitEngine band_split_engine (
+            bands.compressors,
+            bands.crossovers,
+            &bands.control_rate_sidechain);
+        auto band_split_seconds = timePerSample(band_split_engine, input);
+        expectWithinRealtimeBudget(band_split_seconds);
+
+        beginTest("Spectral engine cost per sample");
+        SpectralEngine spectral_engine (bands.compressors, bands.crossovers);
+        auto spectral_seconds = timePerSample(spectral_engine, input);
+        expectWithinRealtimeBudget(spectral_seconds);
+
+        // The spectral engine's FFTs are the bulk of its work, and cost
+        // about the same per sample as our dozen or so filter sections per
+        // channel, so it shouldn't be much dearer than the band split
+        expectWithinBudget(
+            *this,
+            "Spectral engine cost, as a multiple of the band split engine's",
+            spectral_seconds / band_split_seconds,
+            max_spectral_to_band_split_ratio);
+    }
+
+private:
+    static constexpr int num_samples = 10 * 44100;
+    static constexpr int host_block_size = 512;
+    static constexpr int num_runs = 5;
+    static constexpr double max_realtime_percentage = 5.0;
+    static constexpr double max_spectral_to_band_split_ratio = 4.0;
+
+    // The median time the engine takes per stereo sample of input, over
+    // num_runs runs through the whole of it
+    static double timePerSample(
+        MultibandEngine& engine,
+        const AudioBuffer<float>& input)
+    {
+        engine.prepare(sample_rate_in_hz, host_block_size, false);
+        AudioBuffer<float> buffer (2, host_block_size);
+
+        std::vector<double> timings;
+        for (auto run = 0; run < num_runs; run++)
+        {
+            engine.reset();
+            auto ticks = (int64) 0;
+            for (auto start_sample = 0;
+                 start_sample + host_block_size <= input.getNumSamples();
+                 start_sample += host_block_size)
+            {
+                // Only the engine is timed, not copying its input in
+                for (auto channel = 0; channel < 2; channel++)
+                    buffer.copyFrom(
+                        channel,
+                        0,
+                        input,
+                        channel,
+                        start_sample,
+                        host_block_size);
+
+                auto start_ticks = Time::getHighResolutionTicks();
+                engine.process(buffer);
+                ticks += Time::getHighResolutionTicks() - start_ticks;
+            }
+            timings.push_back(
+                Time::highResolutionTicksToSeconds(ticks) / input.getNumSamples());
+        }
+        return getMedian(timings);
+    }
+
+    void expectWithinRealtimeBudget(double seconds_per_sample)
+    {
+        logMessage(
+            "Nanoseconds per sample: " + String(seconds_per_sample * 1.0e9, 1));
+        expectWithinBudget(
+            *this,
+            "Percentage of realtime",
+            100.0 * seconds_per_sample * sample_rate_in_hz,
+            max_realtime_percentage);
+    }
+};
+
+constexpr int EngineBenchmark::num_samples;
+constexpr int EngineBenchmark::host_block_size;
+constexpr int EngineBenchmark::num_runs;
+constexpr double EngineBenchmark::max_realtime_percentage;
+constexpr double EngineBenchmark::max_spectral_to_band_split_ratio;
+
+static EngineBenchmark engine_benchmark;
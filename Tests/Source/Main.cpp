@@ -0,0 +1,48 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 19 Oct 2026 2:23:59pm
+    Author:  Ben Hayes
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "TestUtilities.h"
+
+//==============================================================================
+// Runs every test we have, or just one category of them, and exits with a
+// non-zero code if any of them failed, so that ctest can tell.
+//
+// Options:
+//   --category=<name>      only run the tests in this category
+//   --golden-dir=<folder>  where the golden files are (default: ./Golden)
+//   --record-golden        re-record every golden file from this build
+int main (int argc, char* argv[])
+{
+    // Some of our tests open the editor, which needs a message manager
+    ScopedJuceInitialiser_GUI juce_initialiser;
+    ArgumentList arguments (argc, argv);
+
+    auto golden_directory = File::getCurrentWorkingDirectory().getChildFile("Golden");
+    if (arguments.containsOption("--golden-dir"))
+        golden_directory = File::getCurrentWorkingDirectory().getChildFile(
+            arguments.getValueForOption("--golden-dir"));
+    TestUtilities::setGoldenDirectory(golden_directory);
+    TestUtilities::setShouldRecordGoldenFiles(
+        arguments.containsOption("--record-golden"));
+
+    UnitTestRunner runner;
+    runner.setAssertOnFailure(false);
+    if (arguments.containsOption("--category"))
+        runner.runTestsInCategory(arguments.getValueForOption("--category"));
+    else
+        runner.runAllTests();
+
+    auto num_failures = 0;
+    for (auto i = 0; i < runner.getNumResults(); i++)
+        num_failures += runner.getResult(i)->failures;
+
+    return num_failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,150 @@
+/*
+  ==============================================================================
+
+    OfflineRendererTests.cpp
+    Created: 19 Oct 2026 2:39:10pm
+    Author:  Ben Hayes
+
+  ==============================================================================
+*/
+
+#include "TestUtilities.h"
+#include "../../Source/OfflineRenderer.h"
+#include "../../Source/PluginProcessor.h"
+
+using namespace TestUtilities;
+
+class OfflineRendererTests : public UnitTest
+{
+public:
+    OfflineRendererTests() : UnitTest ("Offline renderer", "DSP") {}
+
+    void runTest() override
+    {
+        // A file that doesn't end on a block boundary, so the last block
+        // read is a partial one, and the latency and tail run on past the
+        // end of the file
+        auto input = makeProgramMaterial(num_samples);
+        TemporaryFile input_file (".wav");
+        TemporaryFile output_file (".wav");
+
+        beginTest("Writing the input file");
+        expect(
+            writeFloatWav(input_file.getFile(), input),
+            "Couldn't write " + input_file.getFile().getFullPathName());
+
+        // The spectral engine has a frame of latency, so this checks that
+        // it's trimmed from the start of the output
+        beginTest("Rendering");
+        MultibandCompressorAudioProcessor plugin;
+        setUpPlugin(plugin);
+        OfflineRenderer::Options options;
+        options.block_size = block_size;
+        options.num_blocks = num_blocks;
+        options.output_bits_per_sample = 32;
+        OfflineRenderer renderer (plugin, options);
+        auto result = renderer.render(input_file.getFile(), output_file.getFile());
+        expect(result.wasOk(), result.getErrorMessage());
+
+        // What the renderer should have done: the input with enough
+        // silence after it to flush out the latency and tail, run through
+        // the same plugin in the same blocks, less the latency at the start
+        MultibandCompressorAudioProcessor reference_plugin;
+        setUpPlugin(reference_plugin);
+        reference_plugin.setRateAndBufferSizeDetails(sample_rate_in_hz, block_size);
+        reference_plugin.prepareToPlay(sample_rate_in_hz, block_size);
+        auto latency = reference_plugin.getLatencySamples();
+        auto tail = (int) std::ceil(
+            jmin(reference_plugin.getTailLengthSeconds(), 10.0) * sample_rate_in_hz);
+        expect(latency > 0, "The spectral engine should have some latency");
+
+        AudioBuffer<float> padded (2, latency + num_samples + tail);
+        padded.clear();
+        for (auto channel = 0; channel < 2; channel++)
+            padded.copyFrom(channel, 0, input, channel, 0, num_samples);
+        processInBlocks(reference_plugin, padded, block_size);
+        reference_plugin.releaseResources();
+
+        AudioBuffer<float> expected (2, num_samples + tail);
+        for (auto channel = 0; channel < 2; channel++)
+            expected.copyFrom(channel, 0, padded, channel, latency, num_samples + tail);
+
+        beginTest("Output length");
+        auto output = readWav(output_file.getFile());
+        expectEquals(output.getNumChannels(), 2);
+        expectEquals(output.getNumSamples(), num_samples + tail);
+
+        beginTest("Output lines up with processing in blocks");
+        auto difference_in_db = getMaxDifferenceInDb(output, expected);
+        expect(
+            difference_in_db <= tolerance_in_db,
+            "The render differs from processing in blocks by "
+                + String(difference_in_db, 1) + "dB");
+    }
+
+private:
+    // A second of audio, which isn't a whole number of blocks. A few
+    // small blocks keep the reader and writer threads busy for the whole
+    // render.
+    static constexpr int num_samples = 44100;
+    static constexpr int block_size = 512;
+    static constexpr int num_blocks = 4;
+    // Both files are 32 bit float, so the render should match exactly
+    static constexpr float tolerance_in_db = -140.0f;
+
+    static void setUpPlugin(MultibandCompressorAudioProcessor& plugin)
+    {
+        *plugin.spectral_mode_ = true;
+        for (auto compressor : plugin.compressors_)
+            *compressor->threshold_in_db_ = -30.0f;
+    }
+
+    static bool writeFloatWav(const File& file, const AudioBuffer<float>& buffer)
+    {
+        file.deleteFile();
+        std::unique_ptr<FileOutputStream> stream (file.createOutputStream());
+        if (stream == nullptr)
+            return false;
+
+        WavAudioFormat wav_format;
+        std::unique_ptr<AudioFormatWriter> writer (wav_format.createWriterFor(
+            stream.get(),
+            sample_rate_in_hz,
+            (unsigned int) buffer.getNumChannels(),
+            32,
+            {},
+            0));
+        if (writer == nullptr)
+            return false;
+
+        // The writer owns the stream now
+        stream.release();
+        return writer->writeFromAudioSampleBuffer(
+            buffer,
+            0,
+            buffer.getNumSamples());
+    }
+
+    static AudioBuffer<float> readWav(const File& file)
+    {
+        WavAudioFormat wav_format;
+        std::unique_ptr<AudioFormatReader> reader (wav_format.createReaderFor(
+            file.createInputStream(),
+            true));
+        if (reader == nullptr)
+            return {};
+
+        AudioBuffer<float> buffer (
+            (int) reader->numChannels,
+            (int) reader->lengthInSamples);
+        reader->read(&buffer, 0, buffer.getNumSamples(), 0, true, true);
+        return buffer;
+    }
+};
+
+constexpr int OfflineRendererTests::num_samples;
+constexpr int OfflineRendererTests::block_size;
+constexpr int OfflineRendererTests::num_blocks;
+constexpr float OfflineRendererTests::tolerance_in_db;
+
+static OfflineRendererTests offline_renderer_tests;
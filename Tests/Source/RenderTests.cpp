@@ -0,0 +1,200 @@
+/*
+  ==============================================================================
+
+    RenderTests.cpp
+    Created: 19 Oct 2026 2:23:59pm
+    Author:  Ben Hayes
+
+  ==============================================================================
+*/
+
+#include "TestUtilities.h"
+#include "../../Source/CompressorBankProcessor.h"
+#include "../../Source/PluginProcessor.h"
+#include <functional>
+
+using namespace TestUtilities;
+
+class RenderTests : public UnitTest
+{
+public:
+    RenderTests() : UnitTest ("Render", "DSP") {}
+
+    void runTest() override
+    {
+        auto signals = makeTestSignals(num_samples);
+
+        // Every renderer's output should sound the same as the last time
+        // we listened to it:
+        for (auto& renderer : getRenderers())
+        {
+            beginTest(renderer.name + " matches its golden files");
+            for (auto& signal : signals)
+                expectMatchesGolden(
+                    *this,
+                    renderer.name + "_" + signal.name,
+                    renderer.render(signal.buffer, golden_block_size),
+                    golden_tolerance_in_db);
+        }
+
+        // And it should sound the same whatever size of blocks the host
+        // gives us. Our sub-block schedulers count across host blocks, so
+        // apart from rounding, nothing should depend on where one host
+        // block ends and the next begins.
+        for (auto& renderer : getRenderers())
+        {
+            beginTest(renderer.name + " doesn't depend on the host's block size");
+            for (auto& signal : signals)
+            {
+                auto reference = renderer.render(signal.buffer, golden_block_size);
+                for (auto host_block_size : getHostBlockSizes())
+                {
+                    auto difference_in_db = getMaxDifferenceInDb(
+                        renderer.render(signal.buffer, host_block_size),
+                        reference);
+                    expect(
+                        difference_in_db <= block_size_tolerance_in_db,
+                        signal.name + " at a block size of "
+                            + String(host_block_size) + " differs by "
+                            + String(difference_in_db, 1) + "dB");
+                }
+            }
+        }
+
+        // With nothing compressed, each engine's bands should add back up
+        // to something with a flat magnitude response: the crossovers'
+        // allpasses for the band split engine, and a delay for the spectral
+        // engine.
+        beginTest("Band split engine sums flat");
+        expectSumsFlat(false, band_split_flatness_in_db);
+        beginTest("Spectral engine sums flat");
+        expectSumsFlat(true, spectral_flatness_in_db);
+    }
+
+private:
+    // One second of each test signal, which is plenty for the slowest
+    // release to show up
+    static constexpr int num_samples = 44100;
+    static constexpr int golden_block_size = 512;
+    // The golden files are 24 bit, so this is well above their noise
+    // floor, but far below anything we could hear
+    static constexpr float golden_tolerance_in_db = -90.0f;
+    static constexpr float block_size_tolerance_in_db = -140.0f;
+    static constexpr int flatness_fft_order = 15;
+    static constexpr float band_split_flatness_in_db = 0.01f;
+    static constexpr float spectral_flatness_in_db = 0.1f;
+
+    struct Renderer
+    {
+        String name;
+        std::function<AudioBuffer<float>(const AudioBuffer<float>&, int)> render;
+    };
+
+    static std::vector<Renderer> getRenderers()
+    {
+        return {
+            {"crossover", renderCrossover},
+            {"compressor", renderCompressor},
+            {"plugin", renderPlugin}};
+    }
+
+    // One crossover at 1kHz. The output has the low band on the first
+    // two channels and the high band on the next two.
+    static AudioBuffer<float> renderCrossover(
+        const AudioBuffer<float>& input,
+        int host_block_size)
+    {
+        CrossoverFilterProcessor crossover (0, 1000.0f);
+        auto parameter_tree = crossover.getParameterTree();
+        crossover.prepareToPlay(sample_rate_in_hz, host_block_size);
+        crossover.reset();
+
+        AudioBuffer<float> buffer (4, input.getNumSamples());
+        buffer.clear();
+        for (auto channel = 0; channel < 2; channel++)
+            buffer.copyFrom(channel, 0, input, channel, 0, input.getNumSamples());
+        processInBlocks(crossover, buffer, host_block_size);
+        return buffer;
+    }
+
+    // One band of the compressor bank, set to compress hard and fast
+    // enough that all of its stages have something to do
+    static AudioBuffer<float> renderCompressor(
+        const AudioBuffer<float>& input,
+        int host_block_size)
+    {
+        TestBands bands (1);
+        auto compressor = bands.compressors[0];
+        *compressor->threshold_in_db_ = -24.0f;
+        *compressor->ratio_ = 4.0f;
+        *compressor->knee_in_db_ = 6.0f;
+        *compressor->attack_in_seconds_ = 5.0f;
+        *compressor->release_in_seconds_ = 80.0f;
+
+        CompressorBankProcessor compressor_bank (
+            bands.compressors,
+            &bands.control_rate_sidechain);
+        compressor_bank.prepareToPlay(sample_rate_in_hz, host_block_size);
+
+        AudioBuffer<float> buffer (input);
+        processInBlocks(compressor_bank, buffer, host_block_size);
+        return buffer;
+    }
+
+    // The whole plugin, with every band compressing
+    static AudioBuffer<float> renderPlugin(
+        const AudioBuffer<float>& input,
+        int host_block_size)
+    {
+        MultibandCompressorAudioProcessor plugin;
+        for (auto compressor : plugin.compressors_)
+            *compressor->threshold_in_db_ = -30.0f;
+        plugin.prepareToPlay(sample_rate_in_hz, host_block_size);
+
+        AudioBuffer<float> buffer (input);
+        processInBlocks(plugin, buffer, host_block_size);
+        plugin.releaseResources();
+        return buffer;
+    }
+
+    void expectSumsFlat(bool use_spectral_engine, float tolerance_in_db)
+    {
+        // A quiet impulse, so that even with a ratio of 1 nothing is near
+        // a threshold
+        auto fft_size = 1 << flatness_fft_order;
+        AudioBuffer<float> buffer (2, fft_size);
+        buffer.clear();
+        buffer.setSample(0, 0, 0.01f);
+        buffer.setSample(1, 0, 0.01f);
+
+        MultibandCompressorAudioProcessor plugin;
+        *plugin.spectral_mode_ = use_spectral_engine;
+        for (auto compressor : plugin.compressors_)
+            *compressor->ratio_ = 1.0f;
+        plugin.prepareToPlay(sample_rate_in_hz, golden_block_size);
+        processInBlocks(plugin, buffer, golden_block_size);
+        plugin.releaseResources();
+
+        for (auto channel = 0; channel < 2; channel++)
+        {
+            buffer.applyGain(channel, 0, fft_size, 100.0f);
+            auto deviation_in_db = getMaxDeviationFromFlatInDb(
+                buffer.getReadPointer(channel),
+                flatness_fft_order);
+            expect(
+                deviation_in_db <= tolerance_in_db,
+                "Channel " + String(channel) + " strays "
+                    + String(deviation_in_db, 3) + "dB from flat");
+        }
+    }
+};
+
+constexpr int RenderTests::num_samples;
+constexpr int RenderTests::golden_block_size;
+constexpr float RenderTests::golden_tolerance_in_db;
+constexpr float RenderTests::block_size_tolerance_in_db;
+constexpr int RenderTests::flatness_fft_order;
+constexpr float RenderTests::band_split_flatness_in_db;
+constexpr float RenderTests::spectral_flatness_in_db;
+
+static RenderTests render_tests;
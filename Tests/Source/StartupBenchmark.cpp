@@ -0,0 +1,127 @@
+/*
+  ==============================================================================
+
+    StartupBenchmark.cpp
+    Created: 19 Oct 2026 2:27:03pm
+    Author:  Ben Hayes
+
+  ==============================================================================
+*/
+
+#include "TestUtilities.h"
+#include "../../Source/PluginProcessor.h"
+
+using namespace TestUtilities;
+
+class StartupBenchmark : public UnitTest
+{
+public:
+    StartupBenchmark() : UnitTest ("Startup", "Benchmarks") {}
+
+    void runTest() override
+    {
+        // A session reload constructs every instance, prepares it, and
+        // maybe creates its editor, so we time each of those per instance,
+        // over enough instances that the first one's one-off costs (fonts,
+        // shared tables etc.) don't count.
+        std::vector<double> construction_timings;
+        std::vector<double> preparation_timings;
+        std::vector<double> hidden_editor_timings;
+        std::vector<double> editor_opening_timings;
+        auto can_show_editors = canShowWindows();
+
+        for (auto instance = 0; instance < num_instances; instance++)
+        {
+            auto start_ticks = Time::getHighResolutionTicks();
+            auto plugin = std::make_unique<MultibandCompressorAudioProcessor>();
+            construction_timings.push_back(getMillisecondsSince(start_ticks));
+
+            start_ticks = Time::getHighResolutionTicks();
+            plugin->prepareToPlay(sample_rate_in_hz, host_block_size);
+            preparation_timings.push_back(getMillisecondsSince(start_ticks));
+
+            // Hosts often create editors they never show, which should
+            // cost next to nothing, since the controls aren't built until
+            // the editor is first on screen
+            start_ticks = Time::getHighResolutionTicks();
+            std::unique_ptr<AudioProcessorEditor> editor (plugin->createEditor());
+            hidden_editor_timings.push_back(getMillisecondsSince(start_ticks));
+            editor.reset();
+
+            if (can_show_editors)
+            {
+                start_ticks = Time::getHighResolutionTicks();
+                editor.reset(plugin->createEditor());
+                editor->addToDesktop(0);
+                editor->setVisible(true);
+                editor_opening_timings.push_back(getMillisecondsSince(start_ticks));
+                editor.reset();
+            }
+
+            plugin->releaseResources();
+        }
+
+        beginTest("Construction");
+        expectWithinBudget(
+            *this,
+            "Milliseconds to construct",
+            getMedian(construction_timings),
+            max_construction_in_ms);
+
+        beginTest("Preparation");
+        expectWithinBudget(
+            *this,
+            "Milliseconds to prepare",
+            getMedian(preparation_timings),
+            max_preparation_in_ms);
+
+        beginTest("Editor opening");
+        expectWithinBudget(
+            *this,
+            "Milliseconds to create a hidden editor",
+            getMedian(hidden_editor_timings),
+            max_hidden_editor_in_ms);
+        if (can_show_editors)
+            expectWithinBudget(
+                *this,
+                "Milliseconds to open an editor",
+                getMedian(editor_opening_timings),
+                max_editor_opening_in_ms);
+        else
+            logMessage("No display to open editors on, so skipped opening them");
+    }
+
+private:
+    static constexpr int num_instances = 25;
+    static constexpr int host_block_size = 512;
+    static constexpr double max_construction_in_ms = 2.0;
+    static constexpr double max_preparation_in_ms = 10.0;
+    static constexpr double max_hidden_editor_in_ms = 1.0;
+    static constexpr double max_editor_opening_in_ms = 50.0;
+
+    static double getMillisecondsSince(int64 start_ticks)
+    {
+        return 1000.0 * Time::highResolutionTicksToSeconds(
+            Time::getHighResolutionTicks() - start_ticks);
+    }
+
+    // Headless Linux machines (like most CI runners) have no X display to
+    // put a window on
+    static bool canShowWindows()
+    {
+       #if JUCE_LINUX
+        return SystemStats::getEnvironmentVariable("DISPLAY", {}).isNotEmpty();
+       #else
+        return true;
+       #endif
+    }
+};
+
+constexpr int StartupBenchmark::num_instances;
+constexpr int StartupBenchmark::host_block_size;
+constexpr double StartupBenchmark::max_construction_in_ms;
+constexpr double StartupBenchmark::max_preparation_in_ms;
+constexpr double StartupBenchmark::max_hidden_editor_in_ms;
+constexpr double StartupBenchmark::max_editor_opening_in_ms;
+
+static StartupBenchmark startup_benchmark;
@@ -0,0 +1,341 @@
+/*
+  ==============================================================================
+
+    TestUtilities.cpp
+    Created: 19 Oct 2026 2:23:59pm
+    Author:  Ben Hayes
+
+  ==============================================================================
+*/
+
+#include "TestUtilities.h"
+
+namespace TestUtilities
+{
+    static File golden_directory;
+    static bool should_record_golden_files = false;
+
+    // A xorshift generator for the noisy test signals. We use our own
+    // rather than juce::Random, so that the signals, and the golden files
+    // rendered from them, can't change under us with a JUCE update.
+    class NoiseGenerator
+    {
+    public:
+        explicit NoiseGenerator(uint32 seed) : state_ (seed)
+        {
+            jassert(seed != 0);
+        }
+
+        // Uniformly distributed between -1 and 1
+        double nextSample() noexcept
+        {
+            state_ ^= state_ << 13;
+            state_ ^= state_ >> 17;
+            state_ ^= state_ << 5;
+            return state_ / 2147483648.0 - 1.0;
+        }
+
+    private:
+        uint32 state_;
+    };
+
+    const std::vector<int>& getHostBlockSizes()
+    {
+        static const std::vector<int> host_block_sizes {1, 17, 64, 512, 4096};
+        return host_block_sizes;
+    }
+
+    AudioBuffer<float> makeSweep(int num_samples)
+    {
+        // The phase of an exponential sweep is the integral of its
+        // frequency, which we can write down directly rather than
+        // accumulating it sample by sample:
+        AudioBuffer<float> buffer (2, num_samples);
+        auto start_in_hz = 20.0;
+        auto end_in_hz = 20000.0;
+        auto duration_in_seconds = num_samples / sample_rate_in_hz;
+        auto rate = std::log(end_in_hz / start_in_hz) / duration_in_seconds;
+        for (auto n = 0; n < num_samples; n++)
+        {
+            auto time_in_seconds = n / sample_rate_in_hz;
+            auto phase = MathConstants<double>::twoPi * start_in_hz
+                * (std::exp(rate * time_in_seconds) - 1.0) / rate;
+            auto sample = (float) (0.5 * std::sin(phase));
+            buffer.setSample(0, n, sample);
+            buffer.setSample(1, n, sample);
+        }
+        return buffer;
+    }
+
+    AudioBuffer<float> makeImpulses(int num_samples)
+    {
+        AudioBuffer<float> buffer (2, num_samples);
+        buffer.clear();
+        auto spacing = (int) (sample_rate_in_hz / 4.0);
+        auto sign = 1.0f;
+        for (auto n = spacing / 2; n < num_samples; n += spacing)
+        {
+            buffer.setSample(0, n, 0.5f * sign);
+            buffer.setSample(1, n, 0.5f * sign);
+            sign = -sign;
+        }
+        return buffer;
+    }
+
+    AudioBuffer<float> makeNoiseBursts(int num_samples)
+    {
+        // Each channel gets its own noise, so the bursts aren't mono
+        AudioBuffer<float> buffer (2, num_samples);
+        buffer.clear();
+        NoiseGenerator noise (0x6e6f6973);
+        auto spacing = (int) (sample_rate_in_hz * 0.2);
+        auto burst_length = (int) (sample_rate_in_hz * 0.05);
+        for (auto n = 0; n < num_samples; n++)
+        {
+            if (n % spacing >= burst_length)
+                continue;
+            for (auto channel = 0; channel < 2; channel++)
+                buffer.setSample(
+                    channel,
+                    n,
+                    (float) (0.5 * noise.nextSample()));
+        }
+        return buffer;
+    }
+
+    AudioBuffer<float> makeProgramMaterial(int num_samples)
+    {
+        // A kick on every beat at 120bpm, whose pitch drops from 120Hz to
+        // 50Hz as it decays, a bass line holding the root and fifth of A,
+        // and hi-hats on every 8th note, panned slightly right.
+        AudioBuffer<float> buffer (2, num_samples);
+        buffer.clear();
+        NoiseGenerator noise (0x70726f67);
+        auto beat_length = (int) (sample_rate_in_hz * 0.5);
+        auto hat_length = beat_length / 2;
+        auto kick_phase = 0.0;
+        auto bass_phase = 0.0;
+        for (auto n = 0; n < num_samples; n++)
+        {
+            auto time_in_beat = (n % beat_length) / sample_rate_in_hz;
+            auto time_in_hat = (n % hat_length) / sample_rate_in_hz;
+            auto beat = n / beat_length;
+
+            if (n % beat_length == 0)
+                kick_phase = 0.0;
+            auto kick_frequency_in_hz = 50.0 + 70.0 * std::exp(-time_in_beat * 30.0);
+            kick_phase += MathConstants<double>::twoPi * kick_frequency_in_hz
+                / sample_rate_in_hz;
+            auto kick = 0.3 * std::exp(-time_in_beat * 8.0) * std::sin(kick_phase);
+
+            auto bass_frequency_in_hz = beat % 2 == 0 ? 55.0 : 82.41;
+            bass_phase += MathConstants<double>::twoPi * bass_frequency_in_hz
+                / sample_rate_in_hz;
+            auto bass = 0.12 * std::sin(bass_phase);
+
+            auto hat = 0.1 * std::exp(-time_in_hat * 60.0) * noise.nextSample();
+
+            buffer.setSample(0, n, (float) (kick + bass + 0.7 * hat));
+            buffer.setSample(1, n, (float) (kick + bass + hat));
+        }
+        return buffer;
+    }
+
+    std::vector<TestSignal> makeTestSignals(int num_samples)
+    {
+        std::vector<TestSignal> signals;
+        signals.push_back({"sweep", makeSweep(num_samples)});
+        signals.push_back({"impulse", makeImpulses(num_samples)});
+        signals.push_back({"noise", makeNoiseBursts(num_samples)});
+        signals.push_back({"program", makeProgramMaterial(num_samples)});
+        return signals;
+    }
+
+    float getMaxDifferenceInDb(
+        const AudioBuffer<float>& a,
+        const AudioBuffer<float>& b)
+    {
+        if (a.getNumChannels() != b.getNumChannels()
+            || a.getNumSamples() != b.getNumSamples())
+            return std::numeric_limits<float>::infinity();
+
+        auto max_difference = 0.0f;
+        for (auto channel = 0; channel < a.getNumChannels(); channel++)
+        {
+            auto a_samples = a.getReadPointer(channel);
+            auto b_samples = b.getReadPointer(channel);
+            for (auto n = 0; n < a.getNumSamples(); n++)
+                max_difference = jmax(
+                    max_difference,
+                    std::abs(a_samples[n] - b_samples[n]));
+        }
+        return Decibels::gainToDecibels(max_difference, -300.0f);
+    }
+
+    float getMaxDeviationFromFlatInDb(const float* impulse_response, int fft_order)
+    {
+        dsp::FFT fft (fft_order);
+        auto fft_size = fft.getSize();
+        std::vector<float> fft_buffer (2 * (size_t) fft_size, 0.0f);
+        std::copy(impulse_response, impulse_response + fft_size, fft_buffer.begin());
+        fft.performFrequencyOnlyForwardTransform(fft_buffer.data());
+
+        auto max_deviation_in_db = 0.0f;
+        for (auto bin = 0; bin <= fft_size / 2; bin++)
+            max_deviation_in_db = jmax(
+                max_deviation_in_db,
+                std::abs(Decibels::gainToDecibels(
+                    fft_buffer[(size_t) bin],
+                    -300.0f)));
+        return max_deviation_in_db;
+    }
+
+    double getMedian(std::vector<double> values)
+    {
+        if (values.empty())
+            return 0.0;
+
+        auto middle = values.begin() + (std::ptrdiff_t) values.size() / 2;
+        std::nth_element(values.begin(), middle, values.end());
+        return *middle;
+    }
+
+    void expectWithinBudget(
+        UnitTest& test,
+        const String& description,
+        double value,
+        double budget)
+    {
+        test.logMessage(
+            description + ": " + String(value, 3)
+            + " (budget " + String(budget, 3) + ")");
+       #if ! JUCE_DEBUG
+        test.expect(value <= budget, description + " is over budget");
+       #endif
+    }
+
+    void setGoldenDirectory(const File& directory)
+    {
+        golden_directory = directory;
+    }
+
+    File getGoldenDirectory()
+    {
+        return golden_directory;
+    }
+
+    void setShouldRecordGoldenFiles(bool should_record)
+    {
+        should_record_golden_files = should_record;
+    }
+
+    static bool writeGolden(const File& file, const AudioBuffer<float>& output)
+    {
+        // 24 bits keeps the files a reasonable size, and its noise floor is
+        // far below any tolerance we compare with
+        file.getParentDirectory().createDirectory();
+        file.deleteFile();
+        std::unique_ptr<FileOutputStream> stream (file.createOutputStream());
+        if (stream == nullptr)
+            return false;
+
+        WavAudioFormat wav_format;
+        std::unique_ptr<AudioFormatWriter> writer (wav_format.createWriterFor(
+            stream.get(),
+            sample_rate_in_hz,
+            (unsigned int) output.getNumChannels(),
+            24,
+            {},
+            0));
+        if (writer == nullptr)
+            return false;
+
+        // The writer owns the stream now
+        stream.release();
+        return writer->writeFromAudioSampleBuffer(
+            output,
+            0,
+            output.getNumSamples());
+    }
+
+    void expectMatchesGolden(
+        UnitTest& test,
+        const String& name,
+        const AudioBuffer<float>& output,
+        float tolerance_in_db)
+    {
+        auto file = golden_directory.getChildFile(name + ".wav");
+        if (should_record_golden_files)
+        {
+            test.expect(
+                writeGolden(file, output),
+                "Couldn't record " + file.getFullPathName());
+            test.logMessage("Recorded golden file " + file.getFullPathName());
+            return;
+        }
+
+        // A missing golden file fails, rather than quietly recording
+        // whatever this build happens to do, which would pass anything
+        if (! file.existsAsFile())
+        {
+            test.expect(
+                false,
+                "No golden file " + file.getFullPathName()
+                    + ". If this render is new, listen to it and record it"
+                    + " with --record-golden.");
+            return;
+        }
+
+        WavAudioFormat wav_format;
+        std::unique_ptr<AudioFormatReader> reader (wav_format.createReaderFor(
+            file.createInputStream(),
+            true));
+        if (reader == nullptr)
+        {
+            test.expect(false, "Couldn't read " + file.getFullPathName());
+            return;
+        }
+
+        AudioBuffer<float> golden (
+            (int) reader->numChannels,
+            (int) reader->lengthInSamples);
+        reader->read(&golden, 0, golden.getNumSamples(), 0, true, true);
+
+        auto difference_in_db = getMaxDifferenceInDb(output, golden);
+        test.expect(
+            difference_in_db <= tolerance_in_db,
+            name + " differs from its golden file by "
+                + String(difference_in_db, 1) + "dB");
+    }
+
+    TestBands::TestBands(int num_bands)
+    {
+        // The same bands and crossovers as the plugin's, with their
+        // parameters held in trees that we own, since there's no plugin to
+        // hand them to:
+        for (auto i = 0; i < num_bands; i++)
+        {
+            auto compressor_processor = std::make_unique<CompressorProcessor>(i);
+            parameter_trees_.push_back(compressor_processor->getParameterTree());
+            compressors.add(compressor_processor.get());
+            compressor_processors_.push_back(std::move(compressor_processor));
+        }
+
+        for (auto i = 0; i < num_bands - 1; i++)
+        {
+            auto default_cutoff_in_hz = 40.0 + pow(
+                2,
+                (i + 3) * log2(19960.0) / (num_bands + 2));
+            auto crossover_processor = std::make_unique<CrossoverFilterProcessor>(
+                i,
+                (float) default_cutoff_in_hz);
+            parameter_trees_.push_back(crossover_processor->getParameterTree());
+            crossovers.add(crossover_processor.get());
+            crossover_processors_.push_back(std::move(crossover_processor));
+        }
+
+        for (auto i = 0; i < crossovers.size(); i++)
+            for (auto j = i + 1; j < crossovers.size(); j++)
+                crossovers[i]->addPhaseCompensationFor(*crossovers[j]);
+    }
+}
@@ -0,0 +1,138 @@
+/*
+  ==============================================================================
+
+    TestUtilities.h
+    Created: 19 Oct 2026 2:23:59pm
+    Author:  Ben Hayes
+    Description:
+
+    Everything the tests share: the fixed test signals, running a processor
+    over a buffer in host-sized blocks, and comparing a render against its
+    golden file.
+
+    The test signals are generated rather than stored, from fixed seeds, so
+    they're the same on every run and every machine. Golden files are the
+    renders we've listened to and are happy with. They live in the Golden
+    folder next to this project, and are only ever written when the tests
+    are run with --record-golden. A missing one is a failure, so a change
+    that's meant to alter the sound, or add a render, is committed along
+    with its new golden files.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "../../Source/CompressorProcessor.h"
+#include "../../Source/CrossoverFilterProcessor.h"
+#include <vector>
+
+namespace TestUtilities
+{
+    // Every test signal and golden file is at this rate
+    constexpr double sample_rate_in_hz = 44100.0;
+
+    // The block sizes we check every processor gives the same output at.
+    // 1 and 17 never line up with our sub-blocks, and 4096 spans many of
+    // them.
+    const std::vector<int>& getHostBlockSizes();
+
+    struct TestSignal
+    {
+        String name;
+        AudioBuffer<float> buffer;
+    };
+
+    // Stereo test signals, peaking at around -6dBFS:
+    //   sweep:   an exponential sine sweep from 20Hz to 20kHz
+    //   impulse: a click every quarter of a second, alternating in sign
+    //   noise:   50ms bursts of white noise every 200ms
+    //   program: a kick, bass line and hi-hats, like a sparse drum loop
+    AudioBuffer<float> makeSweep(int num_samples);
+    AudioBuffer<float> makeImpulses(int num_samples);
+    AudioBuffer<float> makeNoiseBursts(int num_samples);
+    AudioBuffer<float> makeProgramMaterial(int num_samples);
+    std::vector<TestSignal> makeTestSignals(int num_samples);
+
+    // Runs the whole of buffer through processor in place, handing it to
+    // the processor host_block_size samples at a time like a host would.
+    template <typename FloatType>
+    void processInBlocks(
+        AudioProcessor& processor,
+        AudioBuffer<FloatType>& buffer,
+        int host_block_size)
+    {
+        MidiBuffer midi_messages;
+        for (auto start_sample = 0;
+             start_sample < buffer.getNumSamples();
+             start_sample += host_block_size)
+        {
+            auto num_samples = jmin(
+                host_block_size,
+                buffer.getNumSamples() - start_sample);
+            AudioBuffer<FloatType> block (
+                buffer.getArrayOfWritePointers(),
+                buffer.getNumChannels(),
+                start_sample,
+                num_samples);
+            processor.processBlock(block, midi_messages);
+        }
+    }
+
+    // The largest difference between two buffers' samples, in dB relative
+    // to full scale. Buffers of different shapes are infinitely different.
+    float getMaxDifferenceInDb(
+        const AudioBuffer<float>& a,
+        const AudioBuffer<float>& b);
+
+    // How far the magnitude response of impulse_response strays from 0dB
+    // at its worst, in dB
+    float getMaxDeviationFromFlatInDb(const float* impulse_response, int fft_order);
+
+    // The median of a benchmark's timings, which is less thrown by the
+    // odd interruption than the mean
+    double getMedian(std::vector<double> values);
+
+    // Checks a benchmark's result against its budget. Debug builds are far
+    // too slow for their timings to mean anything, so there we only log
+    // them.
+    void expectWithinBudget(
+        UnitTest& test,
+        const String& description,
+        double value,
+        double budget);
+
+    // Where golden files are read from and recorded to
+    void setGoldenDirectory(const File& directory);
+    File getGoldenDirectory();
+    void setShouldRecordGoldenFiles(bool should_record);
+
+    // Expects output to be within tolerance_in_db of the golden file called
+    // name, or records it instead with --record-golden.
+    void expectMatchesGolden(
+        UnitTest& test,
+        const String& name,
+        const AudioBuffer<float>& output,
+        float tolerance_in_db);
+
+    // A set of band and crossover parameters, owned the same way the plugin
+    // owns them, for testing the DSP on its own.
+    class TestBands
+    {
+    public:
+        TestBands(int num_bands);
+
+        Array<CompressorProcessor*> compressors;
+        Array<CrossoverFilterProcessor*> crossovers;
+        AudioParameterBool control_rate_sidechain {
+            "control_rate_sidechain",
+            "Control Rate Sidechain",
+            false};
+
+    private:
+        std::vector<std::unique_ptr<CompressorProcessor>> compressor_processors_;
+        std::vector<std::unique_ptr<CrossoverFilterProcessor>> crossover_processors_;
+        std::vector<std::unique_ptr<AudioProcessorParameterGroup>> parameter_trees_;
+    };
+}